@@ -0,0 +1,348 @@
+// Title        : ACOSolver.cpp
+// Purpose      : Builds boards with ants guided by a pheromone matrix
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#include "ACOSolver.h"          // Class declaration
+#include <algorithm>            // nth_element(), min(), max()
+
+
+ACOSolver::ACOSolver(BoardManager* manager)                 // *In*
+  : ModelSolver(manager)
+{ // Stores the board manager of the solver and makes a worker for each
+  // hardware thread
+
+  workers.resize(workerCount);      // One worker per hardware thread
+
+} // ACOSolver()
+
+
+void ACOSolver::reset()
+{ // Sets every choice to the highest pheromone and seeds the workers.
+  // Called once the locks are built and whenever the population restarts
+
+  std::vector<std::vector<PuzzlePiece>>* pieces =
+    boardMan->getPieces();          // Pieces of each type
+  std::vector<int>* slots = nullptr;  // Free slots of a type
+  int size = boardMan->getSize();   // Last index of board
+  int pieceCount = 0;               // Free pieces of a type
+
+  pheromone.assign(3, std::vector<float>());
+  columnCounts.assign(3, 0);
+  slotRows.assign((size + 1) * (size + 1), -1);
+  pieceColumns.assign((*pieces)[CORNER].size() + (*pieces)[EDGE].size() +
+                      (*pieces)[INNER].size() + 1, -1);
+
+  for (int type = CORNER; type <= INNER; type++)
+  { // Give each free piece of the type a column and each free slot a row,
+    // then start every choice at the highest pheromone
+
+    pieceCount = 0;
+
+    for (const PuzzlePiece& piece : (*pieces)[type])
+    {
+      if (!boardMan->isPieceLocked(piece.pieceID))
+      {
+        pieceColumns[piece.pieceID] = pieceCount++;
+      }
+    }
+
+    slots = boardMan->getFreeSlots(type);
+
+    for (int row = 0; row < (int)slots->size(); row++)
+    {
+      slotRows[(*slots)[row]] = row;
+    }
+
+    columnCounts[type] = pieceCount * 4;
+    pheromone[type].assign(slots->size() * columnCounts[type], ACOMAX);
+  }
+
+  for (ACOWorker& worker : workers)
+  { // Seed each worker
+    worker.generator.seed(nextSeed());
+  }
+
+} // reset()
+
+
+void ACOSolver::doGeneration(int popSize,                   // *In*
+                             int eliteRate)                 // *In*
+{ // Updates the pheromone from the scored population then replaces it with
+  // boards built by new ants, keeping the best eliteRate boards as they are
+
+  updatePheromone(popSize);         // Lay pheromone from the population
+
+  // Send the ants out, each worker building its own share of the boards
+  nextPopulation(popSize, eliteRate,
+                 [this](Board* theBoard, int worker)
+                 { buildBoard(theBoard, &workers[worker]); });
+
+} // doGeneration()
+
+
+void ACOSolver::updatePheromone(int popSize)                // *In*
+{ // Evaporates the pheromone, lets the best ACODEPOSIT of the scored ants lay
+  // pheromone on their choices in proportion to their fitness, then keeps
+  // every choice between ACOMIN and ACOMAX
+
+  std::shared_ptr<std::vector<Board>> thePop =
+    boardMan->getPop();                       // Scored population
+  int topCount = std::max(1, (int)(popSize * ACODEPOSIT));  // Ants that lay
+  int bestScore = 1;                          // Best fitness of the ants
+  int index[2] = { -1, -1 };                  // Slot index of a free slot
+  float amount = 0.0f;                        // Pheromone laid by an ant
+
+  rankPopulation(popSize);          // Rank the ants without moving them
+
+  // Move the keys of the best ants to the end
+  std::nth_element(keys.begin(), keys.end() - topCount, keys.end());
+
+  // The best ant is among the keys moved to the end
+  bestScore = std::max(bestScore,
+                       std::max_element(keys.end() - topCount,
+                                        keys.end())->fitScore);
+
+  for (int type = CORNER; type <= INNER; type++)
+  { // Update each piece type on its own
+
+    std::vector<int>* slots = boardMan->getFreeSlots(type);
+    float* trail = pheromone[type].data();    // Pheromone of the type
+
+    for (int i = 0; i < (int)pheromone[type].size(); i++)
+    { // Evaporate every choice. A plain loop over the whole matrix so the
+      // compiler can vectorise it
+      trail[i] *= 1.0f - ACOEVAPORATE;
+    }
+
+    for (int k = popSize - topCount; k < popSize; k++)
+    { // Each of the best ants lays more the closer it is to the best ant
+
+      Board* theBoard = &thePop->at(keys[k].index);
+
+      amount = ACOMAX * ACOEVAPORATE * keys[k].fitScore / bestScore;
+
+      for (int row = 0; row < (int)slots->size(); row++)
+      {
+        boardMan->getSlotIndex((*slots)[row], index);
+
+        const PackedPiece& slot = theBoard->boardVecs[index[0]][index[1]];
+
+        trail[row * columnCounts[type] + pieceColumns[slot.pieceID] * 4 +
+              slot.orientation] += amount;
+      }
+    }
+
+    for (int i = 0; i < (int)pheromone[type].size(); i++)
+    { // Keep every choice within the bounds so no choice is ever ruled out
+      trail[i] = std::min(ACOMAX, std::max(ACOMIN, trail[i]));
+    }
+  }
+
+} // updatePheromone()
+
+
+void ACOSolver::buildBoard(Board* theBoard,                 // *In-Out*
+                           ACOWorker* worker)               // *In-Out*
+{ // Builds one board slot by slot in scan order. Each slot takes an unused
+  // piece and rotation chosen with a chance of pheromone times heuristic,
+  // the heuristic being the matches with the pieces already placed around it
+
+  int size = boardMan->getSize();   // Last index of board
+  int type = -1;                    // Type of piece the slot holds
+  int slot = -1;                    // Slot number of the slot
+  int choice = -1;                  // Choice drawn for the slot
+  float heuristic = 0.0f;           // One more than the matches of a choice
+  float total = 0.0f;               // Total weight of the choices
+  float spin = 0.0f;                // Random point along the weights
+
+  boardMan->shapeBoard(theBoard);   // Full columns with the locks stamped in
+
+  worker->isUsed.assign(pieceColumns.size(), 0);
+
+  for (int i = 1; i < (int)pieceColumns.size(); i++)
+  { // Locked pieces are already on the board
+    worker->isUsed[i] = (pieceColumns[i] == -1);
+  }
+
+  for (int yIndex = 0; yIndex <= size; yIndex++)
+  { // Fill each row from the top
+    for (int xIndex = 0; xIndex <= size; xIndex++)
+    { // Fill each slot of the row from the left
+
+      if (boardMan->isLocked(xIndex, yIndex))
+      { // Locked slots already hold their piece
+        continue;
+      }
+
+      type = boardMan->getSlotType(xIndex, yIndex);
+      slot = xIndex * (size + 1) + yIndex;
+
+      findChoices(theBoard, xIndex, yIndex, worker);
+
+      worker->weights.resize(worker->choices.size());
+      total = 0.0f;
+
+      for (int c = 0; c < (int)worker->choices.size(); c++)
+      { // Weight each choice by its pheromone and the square of its heuristic
+        heuristic = 1.0f + countMatches(theBoard, xIndex, yIndex,
+                                        worker->choices[c]);
+        worker->weights[c] = getPheromone(type, slot, worker->choices[c]) *
+                             heuristic * heuristic;
+        total += worker->weights[c];
+      }
+
+      spin = std::uniform_real_distribution<float>(0.0f, total)(
+               worker->generator);
+
+      for (choice = 0; choice < (int)worker->choices.size() - 1; choice++)
+      { // Walk the weights until the spin is passed
+        spin -= worker->weights[choice];
+
+        if (spin < 0.0f)
+        {
+          break;
+        }
+      }
+
+      theBoard->boardVecs[xIndex][yIndex].pieceID =
+        worker->choices[choice].pieceID;
+      theBoard->boardVecs[xIndex][yIndex].orientation =
+        worker->choices[choice].orientation;
+      worker->isUsed[worker->choices[choice].pieceID] = 1;
+    }
+  }
+
+  boardMan->hashBoard(theBoard);    // Pieces changed, rehash the board
+
+} // buildBoard()
+
+
+void ACOSolver::findChoices(Board* theBoard,                // *In*
+                            int xIndex,                     // *In*
+                            int yIndex,                     // *In*
+                            ACOWorker* worker)              // *In-Out*
+{ // Fills the choices of the worker for the slot given. Uses the pieces from
+  // the colour index that match the left and top of the slot, or every unused
+  // piece of the type if none of those are left
+
+  int type = boardMan->getSlotType(xIndex, yIndex);  // Type the slot holds
+  int left = boardMan->getEdgeColour();  // Colour the left must have
+  int top = boardMan->getEdgeColour();   // Colour the top must have
+  std::vector<PieceRef>* matches = nullptr;  // Pieces with both colours
+  PackedPiece turned;               // Border piece turned to fit the slot
+  PieceRef ref;                     // Choice being added
+
+  if (xIndex > 0)
+  { // Slot to the left is always filled before this one
+    left = boardMan->getPattern(theBoard, xIndex - 1, yIndex, RIGHT);
+  }
+
+  if (yIndex > 0)
+  { // Slot above is always filled before this one
+    top = boardMan->getPattern(theBoard, xIndex, yIndex - 1, BOTTOM);
+  }
+
+  worker->choices.clear();
+  matches = boardMan->getColourMatches(type, left, top);
+
+  if (matches != nullptr)
+  { // Keep the unused pieces, border pieces only in the rotation that puts
+    // their edge against the edge of the board
+    for (const PieceRef& match : *matches)
+    {
+      if (worker->isUsed[match.pieceID])
+      {
+        continue;
+      }
+
+      if (type != INNER)
+      {
+        turned.pieceID = match.pieceID;
+        turned.orientation = 0;
+        boardMan->fixOrien(&turned, xIndex, yIndex);
+
+        if ((int)turned.orientation != match.orientation)
+        {
+          continue;
+        }
+      }
+
+      worker->choices.push_back(match);
+    }
+  }
+
+  if (worker->choices.empty())
+  { // No unused piece fits both colours, offer every unused piece instead
+    for (const PuzzlePiece& piece : (*boardMan->getPieces())[type])
+    {
+      if (worker->isUsed[piece.pieceID])
+      {
+        continue;
+      }
+
+      ref.pieceID = piece.pieceID;
+
+      if (type == INNER)
+      { // Inner pieces can take any rotation
+        for (ref.orientation = 0; ref.orientation < 4; ref.orientation++)
+        {
+          worker->choices.push_back(ref);
+        }
+      }
+      else
+      { // Border pieces always face the edge of the board
+        turned.pieceID = piece.pieceID;
+        turned.orientation = 0;
+        boardMan->fixOrien(&turned, xIndex, yIndex);
+        ref.orientation = turned.orientation;
+        worker->choices.push_back(ref);
+      }
+    }
+  }
+
+} // findChoices()
+
+
+int ACOSolver::countMatches(Board* theBoard,                // *In*
+                            int xIndex,                     // *In*
+                            int yIndex,                     // *In*
+                            PieceRef choice)                // *In*
+{ // Returns how many sides of the piece and rotation given match the pieces
+  // already placed around the slot, counting locked slots as placed
+
+  int size = boardMan->getSize();   // Last index of board
+  int matches = 0;                  // Sides that match
+
+  if (xIndex > 0 &&
+      boardMan->getSegment(choice.pieceID, choice.orientation, LEFT) ==
+      boardMan->getPattern(theBoard, xIndex - 1, yIndex, RIGHT))
+  {
+    matches++;
+  }
+
+  if (yIndex > 0 &&
+      boardMan->getSegment(choice.pieceID, choice.orientation, TOP) ==
+      boardMan->getPattern(theBoard, xIndex, yIndex - 1, BOTTOM))
+  {
+    matches++;
+  }
+
+  if (xIndex < size && boardMan->isLocked(xIndex + 1, yIndex) &&
+      boardMan->getSegment(choice.pieceID, choice.orientation, RIGHT) ==
+      boardMan->getPattern(theBoard, xIndex + 1, yIndex, LEFT))
+  {
+    matches++;
+  }
+
+  if (yIndex < size && boardMan->isLocked(xIndex, yIndex + 1) &&
+      boardMan->getSegment(choice.pieceID, choice.orientation, BOTTOM) ==
+      boardMan->getPattern(theBoard, xIndex, yIndex + 1, TOP))
+  {
+    matches++;
+  }
+
+  return matches;                   // Return the sides that match
+
+} // countMatches()
\ No newline at end of file
@@ -0,0 +1,104 @@
+// Title        : ACOSolver.h
+// Purpose      : Builds boards with ants guided by a pheromone matrix
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#define ACOEVAPORATE 0.1f       // Share of the pheromone lost each iteration
+#define ACODEPOSIT   0.05       // Fraction of the ants that lay pheromone
+#define ACOMIN       0.05f      // Lowest pheromone of any choice
+#define ACOMAX       5.0f       // Highest pheromone of any choice
+
+
+#include "ModelSolver.h"        // Elite carry over and threaded filling
+#include <vector>               // Pheromone matrix and scratch space
+#include <random>               // Random numbers of each ant thread
+
+
+struct ACOWorker
+{ // Holds what one ant thread needs, so threads share nothing that they
+  // write to apart from the boards they build
+
+  std::mt19937 generator;             // Random numbers of this thread
+  std::vector<char> isUsed;           // Whether each piece ID is placed
+  std::vector<PieceRef> choices;      // Pieces and rotations for the slot
+  std::vector<float> weights;         // Weight of each choice
+
+}; // ACOWorker
+
+
+class ACOSolver : public ModelSolver
+{
+
+private:
+  // Pheromone of each piece and rotation in each free slot for each piece
+  // type. Rows are the free slots of the type in free slot order, columns
+  // are the free pieces of the type times the four rotations
+  std::vector<std::vector<float>> pheromone;
+
+  // Row of each slot in the pheromone of its type, indexed by
+  // x * (size + 1) + y, -1 if locked
+  std::vector<int> slotRows;
+
+  // Piece column of each piece ID within its piece type, -1 if locked
+  std::vector<int> pieceColumns;
+
+  // Column count of the pheromone of each piece type
+  std::vector<int> columnCounts;
+
+  std::vector<ACOWorker> workers;            // One per ant thread
+
+  // Returns the pheromone of the piece and rotation given in the slot given
+  inline float getPheromone(int type,        // *In*
+                            int slot,        // *In*
+                            PieceRef choice) // *In*
+  {
+    return pheromone[type][slotRows[slot] * columnCounts[type] +
+                           pieceColumns[choice.pieceID] * 4 +
+                           choice.orientation];
+  } // getPheromone()
+
+  // Evaporates the pheromone, lets the best ACODEPOSIT of the scored ants
+  // lay pheromone on their choices in proportion to their fitness, then
+  // keeps every choice between ACOMIN and ACOMAX
+  void updatePheromone(int popSize);         // *In*
+
+  // Builds one board slot by slot in scan order. Each slot takes an unused
+  // piece and rotation chosen with a chance of pheromone times heuristic,
+  // the heuristic being the matches with the pieces already placed around it
+  void buildBoard(Board* theBoard,               // *In-Out*
+                  ACOWorker* worker);            // *In-Out*
+
+  // Fills the choices of the worker for the slot given. Uses the pieces from
+  // the colour index that match the left and top of the slot, or every
+  // unused piece of the type if none of those are left
+  void findChoices(Board* theBoard,              // *In*
+                   int xIndex,                   // *In*
+                   int yIndex,                   // *In*
+                   ACOWorker* worker);           // *In-Out*
+
+  // Returns how many sides of the piece and rotation given match the pieces
+  // already placed around the slot, counting locked slots as placed
+  int countMatches(Board* theBoard,              // *In*
+                   int xIndex,                   // *In*
+                   int yIndex,                   // *In*
+                   PieceRef choice);             // *In*
+
+public:
+  // Stores the board manager of the solver and makes a worker for each
+  // hardware thread
+  ACOSolver(BoardManager* manager);              // *In*
+
+  // Sets every choice to the highest pheromone and seeds the workers.
+  // Called once the locks are built and whenever the population restarts
+  void reset();
+
+  // Updates the pheromone from the scored population then replaces it with
+  // boards built by new ants, keeping the best eliteRate boards as they are
+  void doGeneration(int popSize,                 // *In*
+                    int eliteRate);              // *In*
+
+}; // ACOSolver
\ No newline at end of file
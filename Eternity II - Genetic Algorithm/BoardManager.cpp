@@ -7,15 +7,13 @@
 #include "BoardManager.h"     // Class declaration
 #include "GeneticAlgorithm.h" // Random number generation
 #include <algorithm>          // Random_shuffle()
-#include <time.h>             // time()
-
-
-// Initialise to null
-BoardManager* BoardManager::pInstance = nullptr;
+#include <random>             // Zobrist keys
+#include <iostream>           // Output dropped locks
 
 
 BoardManager::BoardManager()
-{ // Seeds rand() with time and initalises currBoards
+{ // Initialises currBoards with an empty population. Each solver owns its own
+  // board manager so several solvers can run in one process
 
   std::vector<Board> newPop;    // Create a new vector for first population
 
@@ -25,70 +23,144 @@ BoardManager::BoardManager()
   prevBoards = nullptr;    // Init previous generation to null
   boardSize = 15;          // Set default board size to Eternity II size 
   patternNum = 22;         // Set default number of patterns to Eternity II
-
-  // Seed rand with time for random number generation
-  srand((unsigned int)time(NULL));
+  colourCount = 0;         // Colour index is empty until pieces are loaded
+  edgeColour = 0;          // Border colour until pieces are loaded
+  freeSlots.resize(3);     // One list of free slots for each piece type
+  ringScore = -1;          // Border is not locked until a ring is solved
+  ringMatches = 0;         // No ring matches until a ring is solved
+  checkCount = 0;          // No fitness checks until the solver starts
+  zobristPieces = 0;       // Zobrist table is empty until pieces are loaded
 
 } // BoardManager()
 
 
-BoardManager* BoardManager::getInstance()
-{ // Returns the instance to the class, if none currently exists, creates one
-
-  if (!pInstance)
-  { // If not pInstance, create one
-    pInstance = new BoardManager;
-  }
-
-  return pInstance;   // Return the instance
-
-} // getInstance()
-
-
 void BoardManager::switchPop()
-{ // Switch the current population to the old population and create a new
-  // shared vector for the new population
+{ // Switch the current population to the old population and reuse the
+  // population from two generations ago as storage for the new population
 
-  std::vector<Board> newPop; // Create vector for new population
+  // Make current population the previous population and the previous
+  // population the storage for the new population
+  std::swap(prevBoards, currBoards);
 
-  prevBoards = currBoards;   // Make current population the previous population
-
-  // Make the new vector shared and set to current populuation
-  currBoards = std::make_shared<std::vector<Board>>(newPop);
+  if (currBoards == nullptr)
+  { // If there was no previous population, make a new shared vector
+    currBoards = std::make_shared<std::vector<Board>>();
+  }
 
 } // switchPop()
 
 
 void BoardManager::initialiseData(int size,                            // *In*
                                   int patNum)                          // *In*
-{ // Sets how many patterns to be used and how many pieces there are per board
+{ // Sets how many patterns to be used and how many pieces there are per board.
+  // Called once the pieces have been loaded, so the edge colour can be read
+
+  PackedPiece corner = { 0, 0 };  // Corner turned to fit the top left slot
 
   boardSize = size - 1;    // boardSize - 1 to include 0 index
   patternNum = patNum;     // Set number of patterns for the board
 
+  buildSlotTable();        // Work out the type and rotation of each slot
+
+  if (!pieceVec[CORNER].empty())
+  { // The left of a corner turned to fit the top left slot faces the edge
+    corner = packPiece(&pieceVec[CORNER][0]);
+    fixOrien(&corner, 0, 0);
+    edgeColour = getSegment(corner.pieceID, corner.orientation, LEFT);
+  }
+
 } // initialiseData()
 
 
+void BoardManager::buildSlotTable()
+{ // Works out the type of piece and the border rotation of every slot for
+  // the board size, so placing a border piece is a table lookup
+
+  int borderCount = 0;                 // How many sides of a slot are border
+  PackedPiece rotated = { 0, 0 };      // Piece turned to find the rotation
+
+  slotTypes.assign((boardSize + 1) * (boardSize + 1), INNER);
+  slotOriens.assign((boardSize + 1) * (boardSize + 1), 0);
+
+  for (int i = 0; i <= boardSize; i++)
+  { // X index of slot
+    for (int j = 0; j <= boardSize; j++)
+    { // Y index of slot
+
+      borderCount = (i == 0 || i == boardSize) + (j == 0 || j == boardSize);
+      slotTypes[i * (boardSize + 1) + j] = (unsigned char)(2 - borderCount);
+      rotated.orientation = 0;
+
+      if (borderCount == 1)
+      { // Edge slot, store the rotation of an edge piece
+        rotateEdge(&rotated, i, j);
+      }
+      else if (borderCount == 2)
+      { // Corner slot, store the rotation of a corner piece
+        rotateCorner(&rotated, i, j);
+      }
+
+      slotOriens[i * (boardSize + 1) + j] =
+        (unsigned char)rotated.orientation;
+    }
+  }
+
+} // buildSlotTable()
+
+
 void BoardManager::initEmptyBoard(Board* theBoard)                     // *Out*  
 { // Initialises the boards vector of vectors with empty vectors
 
   for (int i = 0; i <= boardSize; i++)
   { // Loop through and create vector of pieces for the board and push on to
     // vector of vectors
-    std::vector<PuzzlePiece> newCol;         // Create new vector for pieces
+    std::vector<PackedPiece> newCol;         // Create new vector for pieces
     theBoard->boardVecs.push_back(newCol);   // Push onto vector of vectors
   }
 
 } // initEmptyBoard()
 
 
-void BoardManager::initFullBoard(Board* theBoard,                      // *Out*
-                                 bool startPiece)                      // *In*
+void BoardManager::shapeBoard(Board* theBoard)                       // *In-Out*
+{ // Makes sure the board has a full column of slots for every column of the
+  // board, keeping any storage the board already has
+
+  theBoard->boardVecs.resize(boardSize + 1);  // One vector for each column
+
+  for (int i = 0; i <= boardSize; i++)
+  { // Give each column a slot for every row, does nothing if already full
+    theBoard->boardVecs[i].resize(boardSize + 1);
+  }
+
+  for (const LockedSlot& lock : locks)
+  { // Stamp each locked piece in to its slot, crossover never copies these
+    theBoard->boardVecs[lock.xIndex][lock.yIndex].pieceID = lock.pieceID;
+    theBoard->boardVecs[lock.xIndex][lock.yIndex].orientation =
+      lock.orientation;
+  }
+
+} // shapeBoard()
+
+
+void BoardManager::initFullBoard(Board* theBoard)                      // *Out*
 { // Creates the inital board filled with randomised order of pieces
 
   theBoard->boardID = (int)currBoards->size() + 1;  // Set the ID of the board
 
   initEmptyBoard(theBoard);       // Fill vector of vectors with empty vectors
+  refillBoard(theBoard);          // Fill the empty vectors with pieces
+
+} // initFullBoard()
+
+
+void BoardManager::refillBoard(Board* theBoard)                      // *In-Out*
+{ // Refills a board that already has its columns with a new randomised order
+  // of pieces, reusing the storage of the columns
+
+  for (int i = 0; i <= boardSize; i++)
+  { // Empty each column, clear keeps the memory for the new pieces
+    theBoard->boardVecs[i].clear();
+  }
 
   for (int i = 0; i < 3; i++)
   { // Loop to shuffle all piece types
@@ -98,12 +170,11 @@ void BoardManager::initFullBoard(Board* theBoard,                      // *Out*
   // Add pieces to empty vectors
   addPieces(theBoard);
 
-  if (startPiece && theBoard->boardVecs[7][8].pieceID != 139)
-  { // If starting piece constraint is active and piece 139 is not in slot [7][8]
-    // place piece 139 in slot [7][8]
-    fixStartPiece(theBoard);
-  }
-} // initFullBoard()
+  // Move the locked pieces in to their slots
+  placeLocks(theBoard);
+
+  hashBoard(theBoard);            // Hash the finished board
+} // refillBoard()
 
 
 int BoardManager::getPattern(Board* theBoard,                          // *In*
@@ -137,25 +208,26 @@ int BoardManager::getPattern(Board* theBoard,                          // *In*
     }
   }
 
-  // Modular of 4 to keep segment index 3 or below
-  return theBoard->boardVecs[xIndex][yIndex].segments[index];
+  // Look up the pattern of the segment in the piece table
+  return pieceTable[theBoard->boardVecs[xIndex][yIndex].pieceID].
+         segments[index];
 
 } // getPattern()
 
 
-void BoardManager::fixOrien(PuzzlePiece* piece,                        // *Out*
+void BoardManager::fixOrien(PackedPiece* piece,                        // *Out*
                             int xIndex,                                // *In*
                             int yIndex)                                // *In*
 { // Rotates the piece to match the edge of the board by setting the orientation
-  // so that the edge pattern matches the edge of the board. 
+  // so that the edge pattern matches the edge of the board. The rotation is
+  // looked up from the slot table, inner pieces and slots are left alone
 
-  if (piece->type == EDGE)         
-  { // If piece is edge, call to rotate edge
-    rotateEdge(piece, xIndex, yIndex);
-  }
-  else if (piece->type == CORNER)  
-  { // If piece is corner, call to rotate corner
-    rotateCorner(piece, xIndex, yIndex);
+  int slot = xIndex * (boardSize + 1) + yIndex;        // Index of the slot
+
+  if (pieceTable[piece->pieceID].type != INNER &&
+      pieceTable[piece->pieceID].type == slotTypes[slot])
+  { // If a border piece is in a slot of its own type, turn it to the edge
+    piece->orientation = slotOriens[slot];
   }
 
 } // fixOrientation()
@@ -166,60 +238,54 @@ void BoardManager::generateBoard(int size,                             // *In*
 { // Generates a new board with random pieces placing all the pieces within
   // the pieces vectors
 
-  Board newBoard;              // Create new board
+  // Grid of generated pieces, boards only hold piece IDs so the patterns of
+  // the new pieces are kept here until they are added to the piece vectors
+  std::vector<std::vector<PuzzlePiece>> newBoard;
 
   boardSize = size - 1;         // Set the board size
   patternNum = pattern;         // Set the number of patterns
 
-  initEmptyBoard(&newBoard);   // Fill board vector with vectors
+  newBoard.resize(boardSize + 1);  // One vector for each column
 
   // Generate top left corner piece
-  newBoard.boardVecs[0].push_back(genCorner(-1, -1));
+  newBoard[0].push_back(genCorner(-1, -1));
 
   // Generate first piece on top edge, needed as corner piece will not match
-  newBoard.boardVecs[1].push_back(genEdge(-1, newBoard.boardVecs[0][0].
-                                          segments[0], RIGHT));
+  newBoard[1].push_back(genEdge(-1, newBoard[0][0].segments[0], RIGHT));
 
   for (int i = 1; i < boardSize - 1; i++)
   { // Generate the next piece of the top edge, using the pattern of the piece
     // created before for pattern match
-    newBoard.boardVecs[i + 1].push_back(genEdge(-1, newBoard.boardVecs[i][0].
-                                                segments[3], RIGHT));
+    newBoard[i + 1].push_back(genEdge(-1, newBoard[i][0].segments[3], RIGHT));
   }
 
   // Generate the top right corner piece
-  newBoard.boardVecs[boardSize].push_back(genCorner(-1, newBoard.boardVecs
-                                                    [boardSize - 1][0].
-                                                    segments[3]));
+  newBoard[boardSize].push_back(genCorner(-1, newBoard[boardSize - 1][0].
+                                              segments[3]));
 
   for (int i = 0; i < boardSize - 1; i++)
   { // Generate the left edge using the pattern from the piece in the slot
     // above
-    newBoard.boardVecs[0].push_back(genEdge(-1, newBoard.boardVecs[0][i].
-                                            segments[1], LEFT));
+    newBoard[0].push_back(genEdge(-1, newBoard[0][i].segments[1], LEFT));
   }
 
   // Generate the inner piece in [1][1] for match with edge piece above
-  newBoard.boardVecs[1].push_back(genInner(newBoard.boardVecs[1][0].
-                                           segments[0], newBoard.
-                                           boardVecs[0][1].segments[0]));
+  newBoard[1].push_back(genInner(newBoard[1][0].segments[0],
+                                 newBoard[0][1].segments[0]));
 
   for (int i = 1; i < boardSize - 1; i++)
   { // Generate the inner pieces in col 1, this is so the pieces can
     // match the pattern of the other pieces after correct orientation
-    newBoard.boardVecs[1].push_back(genInner(newBoard.boardVecs[1][i].
-                                             segments[2], newBoard.
-                                             boardVecs[0][i + 1].segments[0]));
+    newBoard[1].push_back(genInner(newBoard[1][i].segments[2],
+                                   newBoard[0][i + 1].segments[0]));
   }
 
   for (int i = 2; i < boardSize; i++)
   {
     // Generate the first row of inner pieces to make it easier to calculate the 
     // matching pattern
-    newBoard.boardVecs[i].push_back(genInner(newBoard.boardVecs[i][0].
-                                             segments[0],
-                                             newBoard.boardVecs[i - 1][1].
-                                             segments[1]));
+    newBoard[i].push_back(genInner(newBoard[i][0].segments[0],
+                                   newBoard[i - 1][1].segments[1]));
 
   }
 
@@ -227,52 +293,42 @@ void BoardManager::generateBoard(int size,                             // *In*
   { // Loop through to add all inner type pieces
     for (int i = 2; i < boardSize; i++)
     { // Add a piece to col i, matching pattern of piece above and to the left
-      newBoard.boardVecs[i].push_back(genInner(newBoard.boardVecs[i][j - 1].
-                                               segments[2], newBoard.
-                                               boardVecs[i - 1][j].
-                                               segments[1]));
+      newBoard[i].push_back(genInner(newBoard[i][j - 1].segments[2],
+                                     newBoard[i - 1][j].segments[1]));
     }
   }
 
   // Generate first piece of right edge, matching pattern with top right corner
-  newBoard.boardVecs[boardSize].push_back(genEdge(newBoard.
-                                                  boardVecs[boardSize - 1][1].
-                                                  segments[1], newBoard.
-                                                  boardVecs[boardSize][0].
-                                                  segments[0], RIGHT));
+  newBoard[boardSize].push_back(genEdge(newBoard[boardSize - 1][1].segments[1],
+                                        newBoard[boardSize][0].segments[0],
+                                        RIGHT));
 
   for (int i = 1; i < boardSize - 1; i++)
   { // Generate the pieces for the right edge, making sure patterns match
-    newBoard.boardVecs[boardSize].push_back(genEdge(newBoard.
-                                                    boardVecs[boardSize - 1][i + 1]
-                                                    .segments[1], newBoard.
-                                                    boardVecs[boardSize][i].
-                                                    segments[3], RIGHT));
+    newBoard[boardSize].push_back(genEdge(newBoard[boardSize - 1][i + 1].
+                                          segments[1],
+                                          newBoard[boardSize][i].segments[3],
+                                          RIGHT));
   }
 
   // Generate the bottom left corner piece, matching the pattern of the piece
   // above
-  newBoard.boardVecs[0].push_back(genCorner(newBoard.boardVecs[0][boardSize - 1]
-                                            .segments[1], -1));
+  newBoard[0].push_back(genCorner(newBoard[0][boardSize - 1].segments[1], -1));
 
   for (int i = 1; i < boardSize; i++)
   { // Generate the bottom edge of the board, making sure the patterns match
     // piece above and piece to the left
-    newBoard.boardVecs[i].push_back(genEdge(newBoard.   
-                                            boardVecs[i][boardSize - 1].
-                                            segments[2], newBoard.
-                                            boardVecs[i - 1][boardSize].
-                                            segments[1], LEFT));
+    newBoard[i].push_back(genEdge(newBoard[i][boardSize - 1].segments[2],
+                                  newBoard[i - 1][boardSize].segments[1],
+                                  LEFT));
   }
 
   // Generate the bottom right corner piece, matching the piece to the left and
   // above
-  newBoard.boardVecs[boardSize].push_back(genCorner(newBoard.boardVecs
-                                                    [boardSize - 1][boardSize].
-                                                    segments[1], newBoard.
-                                                    boardVecs
-                                                    [boardSize][boardSize - 1].
-                                                    segments[3]));
+  newBoard[boardSize].push_back(genCorner(newBoard[boardSize - 1][boardSize].
+                                          segments[1],
+                                          newBoard[boardSize][boardSize - 1].
+                                          segments[3]));
 
   // Population piece vecs with pieces from board
   populatePieces(&newBoard);
@@ -287,8 +343,8 @@ void BoardManager::initTopEdge(Board* theBoard)                        // *Out*
   for (int i = 0; i <= boardSize - 2; i++)
   { // Add edge pieces to inner 13 vectors (so not left and right most vectors)
     // Rotate as needed
-    fixOrien(&pieceVec[EDGE][i], i + 1, 0);                  // Fix orientation
-    theBoard->boardVecs[i + 1].push_back(pieceVec[EDGE][i]); // Store piece
+    theBoard->boardVecs[i + 1].push_back(packPiece(&pieceVec[EDGE][i]));
+    fixOrien(&theBoard->boardVecs[i + 1].back(), i + 1, 0);  // Fix orientation
   }
 
 } // initTopEdge()
@@ -298,45 +354,46 @@ void BoardManager::initCornersSides(Board* theBoard)                   // *Out*
 { // Initialises the left, right and bottom edges of the board along with
   // the corner slots of the board
 
-  // Fix orientation for top left corner and store in top left corner
-  fixOrien(&pieceVec[CORNER][0], 0, 0);                      // Fix orientation
-  theBoard->boardVecs[0].push_back(pieceVec[CORNER][0]);     // Store piece
+  // Store piece in top left corner and fix orientation
+  theBoard->boardVecs[0].push_back(packPiece(&pieceVec[CORNER][0]));
+  fixOrien(&theBoard->boardVecs[0].back(), 0, 0);
 
-  // Fix orientation for top right corner and store on top right corner
-  fixOrien(&pieceVec[CORNER][1], boardSize, 0);              // Fix orientation
-  theBoard->boardVecs[boardSize].push_back(pieceVec[CORNER][1]); // Store piece
+  // Store piece on top right corner and fix orientation
+  theBoard->boardVecs[boardSize].push_back(packPiece(&pieceVec[CORNER][1]));
+  fixOrien(&theBoard->boardVecs[boardSize].back(), boardSize, 0);
 
   for (int i = 0; i < boardSize - 1; i++)
   { // Loops through and push edge pieces on to the left and right edges
     // of the board rotating as needed
 
-    // Fix orientation for left edge and store next piece on left edge
-    fixOrien(&pieceVec[EDGE][i + boardSize - 1], 0, i + 1);
-    theBoard->boardVecs[0].push_back(pieceVec[EDGE][i + boardSize - 1]);
+    // Store next piece on left edge and fix orientation
+    theBoard->boardVecs[0].push_back(packPiece(&pieceVec[EDGE]
+                                               [i + boardSize - 1]));
+    fixOrien(&theBoard->boardVecs[0].back(), 0, i + 1);
 
-    // Fix orientation for right edge and store next piece on right edge
-    fixOrien(&pieceVec[EDGE][i + (boardSize * 2) - 2], boardSize, i + 1);
-    theBoard->boardVecs[boardSize].push_back(pieceVec[EDGE]
-                                             [i + (boardSize * 2) - 2]);
+    // Store next piece on right edge and fix orientation
+    theBoard->boardVecs[boardSize].push_back(packPiece(&pieceVec[EDGE]
+                                                       [i + (boardSize * 2) - 2]));
+    fixOrien(&theBoard->boardVecs[boardSize].back(), boardSize, i + 1);
   }
 
   for (int i = 0; i <= boardSize - 2; i++)
   { // Loops through and adds an edge piece to each vector for the bottom edge
     // of the board rotating as needed
 
-    // Fix orienation for bottom edge and store next piece on bottom edge
-    fixOrien(&pieceVec[EDGE][i + (boardSize * 3) - 3], i + 1, boardSize);
-    theBoard->boardVecs[i + 1].push_back(pieceVec[EDGE]
-                                         [i + (boardSize * 3) - 3]);
+    // Store next piece on bottom edge and fix orientation
+    theBoard->boardVecs[i + 1].push_back(packPiece(&pieceVec[EDGE]
+                                                   [i + (boardSize * 3) - 3]));
+    fixOrien(&theBoard->boardVecs[i + 1].back(), i + 1, boardSize);
   }
 
-  // Fix orientation for bottom left corner and store on bottom left corner
-  fixOrien(&pieceVec[CORNER][2], 0, boardSize);
-  theBoard->boardVecs[0].push_back(pieceVec[CORNER][2]);
+  // Store piece on bottom left corner and fix orientation
+  theBoard->boardVecs[0].push_back(packPiece(&pieceVec[CORNER][2]));
+  fixOrien(&theBoard->boardVecs[0].back(), 0, boardSize);
 
-  // Fix orientation for bottom right corner and store the next piece
-  fixOrien(&pieceVec[CORNER][3], boardSize, boardSize);
-  theBoard->boardVecs[boardSize].push_back(pieceVec[CORNER][3]);
+  // Store piece on bottom right corner and fix orientation
+  theBoard->boardVecs[boardSize].push_back(packPiece(&pieceVec[CORNER][3]));
+  fixOrien(&theBoard->boardVecs[boardSize].back(), boardSize, boardSize);
 
 } // initCornersSides()
 
@@ -351,10 +408,11 @@ void BoardManager::addPieces(Board* theBoard)                          // *Out*
   // Add edge pieces to vectors that will contain inner pieces
   initTopEdge(theBoard);
 
-  for (PuzzlePiece piece : pieceVec[INNER])
+  for (PuzzlePiece& piece : pieceVec[INNER])
   { // Loop through the collection of pieces
 
-    theBoard->boardVecs[index].push_back(piece); // Add piece to line on board
+    // Add piece to line on board
+    theBoard->boardVecs[index].push_back(packPiece(&piece));
     count++;                                     // Increment counter
 
     if (count == boardSize - 1)
@@ -371,54 +429,49 @@ void BoardManager::addPieces(Board* theBoard)                          // *Out*
 } // addPieces()
 
 
-void BoardManager::fixStartPiece(Board* theBoard)                      // *Out*
-{ // If an official Eternity II solve attempt, make sure the start piece
-  // constraint is met by placing the piece with the ID 139 on slot [7][8]
+void BoardManager::placeLocks(Board* theBoard)                       // *In-Out*
+{ // Swaps every locked piece in to the slot it is locked to with the rotation
+  // it is locked to, fixing the rotation of any border piece moved out
 
-  int xIndex = 1;     // X index for slot
-  int yIndex = 1;     // Y index for slot
+  PackedPiece swapTemp;       // Piece moved out of the locked slot
+  int found[2] = { -1, -1 };  // Index of the slot holding the locked piece
 
-  for (int i = 0; i < (int)pieceVec[INNER].size(); i++)
-  { // Loop through for every inner piece within the board
+  for (const LockedSlot& lock : locks)
+  { // Loop through each lock, finding where the shuffle put the piece
 
-    if (theBoard->boardVecs[xIndex][yIndex].pieceID == 139 && xIndex != 7 &&
-        yIndex != 8)
-    { // If the ID of piece is 139 call subroutine to place piece 139 in slot
-      // [7][8] then break out of loop as no further action is needed
-      swapStartPiece(theBoard, xIndex, yIndex);
-      break;
-    }
-      
-    if (xIndex == boardSize - 1)
-    { // If reached the end of the line for the board, move onto next line
-      // of the board
-      yIndex++;           // Increment y
-      xIndex = 0;         // reset x
-    }
-  }
-
-} // fixStartPiece()
+    found[0] = -1;
 
+    for (int i = 0; i <= boardSize && found[0] < 0; i++)
+    { // X index of slot to check
+      for (int j = 0; j <= boardSize && found[0] < 0; j++)
+      { // Y index of slot to check
+        if (theBoard->boardVecs[i][j].pieceID == (unsigned int)lock.pieceID)
+        { // If slot holds the locked piece, store its index
+          found[0] = i;
+          found[1] = j;
+        }
+      }
+    }
 
-void BoardManager::swapStartPiece(Board* theBoard,                     // *Out*
-                                  int xIndex,                          // *In*  
-                                  int yIndex)                          // *In*
-{ // Swap the piece with the given index with the piece in the starting piece
-  // slot according to the Eternity II rule book. (Slot [7][8])
-
-  // Store piece that is in the starting slot in temp storage
-  PuzzlePiece swapTemp = theBoard->boardVecs[7][8];
+    // Store piece that is in the locked slot in temp storage
+    swapTemp = theBoard->boardVecs[lock.xIndex][lock.yIndex];
 
-  // Place starting piece in the starting slot
-  theBoard->boardVecs[7][8] = theBoard->boardVecs[xIndex][yIndex];
+    // Place piece back in to the slot that the locked piece was located,
+    // pieces of the same type so only border rotations need fixing
+    theBoard->boardVecs[found[0]][found[1]] = swapTemp;
+    fixOrien(&theBoard->boardVecs[found[0]][found[1]], found[0], found[1]);
 
-  // Place piece back in to the slot that the starting piece was located
-  theBoard->boardVecs[xIndex][yIndex] = swapTemp;
+    // Place the locked piece in its slot with its locked rotation, last so a
+    // piece already in its slot is still given the locked rotation
+    theBoard->boardVecs[lock.xIndex][lock.yIndex].pieceID = lock.pieceID;
+    theBoard->boardVecs[lock.xIndex][lock.yIndex].orientation =
+      lock.orientation;
+  }
 
-} // swapStartPiece()
+} // placeLocks()
 
 
-void BoardManager::rotateEdge(PuzzlePiece* piece,                      // *Out*  
+void BoardManager::rotateEdge(PackedPiece* piece,                      // *Out*  
                               int xIndex,                              // *In*
                               int yIndex)                              // *In*
 { // Rotates an edge piece so the edge pattern matches the edge of the board
@@ -445,7 +498,7 @@ void BoardManager::rotateEdge(PuzzlePiece* piece,                      // *Out*
 } // rotateEdge()
 
 
-void BoardManager::rotateCorner(PuzzlePiece* piece,                    // *Out*
+void BoardManager::rotateCorner(PackedPiece* piece,                    // *Out*
                                 int xIndex,                            // *In*
                                 int yIndex)                            // *In*
 { // Rotates an corner piece so the corner pattern matches the edge of the board
@@ -592,29 +645,30 @@ PuzzlePiece BoardManager::genInner(int pattern1,                       // *In*
 } // genInner()
 
 
-void BoardManager::populatePieces(Board* theBoard)                     // *In*
-{ // Fill the piece vectors with the pieces located within the board given as
-  // the parameter
+void BoardManager::populatePieces(
+  std::vector<std::vector<PuzzlePiece>>* pieceGrid)                    // *In*
+{ // Fill the piece vectors with the pieces located within the grid of
+  // generated pieces given as the parameter
 
   int pieceCount = 1;     // Counts number of pieces for pieceID
 
   // Push top left corner on to corner piece vector, set ID and increment count
-  pieceVec[0].push_back(theBoard->boardVecs[0][0]); 
+  pieceVec[0].push_back((*pieceGrid)[0][0]); 
   pieceVec[0][0].pieceID = pieceCount;              // Set piece ID
   pieceCount++;                                     // Increment piece count
 
   // Push top left corner on to corner piece vector, set ID and increment count
-  pieceVec[0].push_back(theBoard->boardVecs[boardSize][0]); 
+  pieceVec[0].push_back((*pieceGrid)[boardSize][0]); 
   pieceVec[0][1].pieceID = pieceCount;                      // Set piece ID
   pieceCount++;                                         // Increment piece count
 
   // Push top left corner on to corner piece vector, set ID and increment count
-  pieceVec[0].push_back(theBoard->boardVecs[0][boardSize]); 
+  pieceVec[0].push_back((*pieceGrid)[0][boardSize]); 
   pieceVec[0][2].pieceID = pieceCount;                      // Set piece ID
   pieceCount++;                                         // Increment piece count
 
   // Push top left corner on to corner piece vector, set ID and increment count
-  pieceVec[0].push_back(theBoard->boardVecs[boardSize][boardSize]);
+  pieceVec[0].push_back((*pieceGrid)[boardSize][boardSize]);
   pieceVec[0][3].pieceID = pieceCount;                     // Set piece ID
   pieceCount++;                                            // Increment count
 
@@ -622,23 +676,23 @@ void BoardManager::populatePieces(Board* theBoard)                     // *In*
   { // Push edge on to edge piece vector
     
     // Push the next top edge piece to the edge piece vectors
-    pieceVec[1].push_back(theBoard->boardVecs[i][0]);
+    pieceVec[1].push_back((*pieceGrid)[i][0]);
     pieceVec[1].back().pieceID = pieceCount;          // Set piece ID
     pieceCount++;                                     // Increment piece count
   
     // Push the next left edge piece to the edge piece vectors
-    pieceVec[1].push_back(theBoard->boardVecs[0][i]);
+    pieceVec[1].push_back((*pieceGrid)[0][i]);
     pieceVec[1].back().pieceID = pieceCount;          // Set piece ID
     pieceCount++;                                     // Increment piece count
 
 
     // Push the next right edge piece to the edge piece vectors
-    pieceVec[1].push_back(theBoard->boardVecs[boardSize][i]);
+    pieceVec[1].push_back((*pieceGrid)[boardSize][i]);
     pieceVec[1].back().pieceID = pieceCount;          // Set piece ID
     pieceCount++;                                     // Increment piece count
 
     // Push the next bottom edgepiece to the edge piece vectors
-    pieceVec[1].push_back(theBoard->boardVecs[i][boardSize]);
+    pieceVec[1].push_back((*pieceGrid)[i][boardSize]);
     pieceVec[1].back().pieceID = pieceCount;          // Set piece ID
     pieceCount++;                                     // Increment piece count
 
@@ -650,7 +704,7 @@ void BoardManager::populatePieces(Board* theBoard)                     // *In*
     { // Y index to push pieces to vector
 
       // Push next inner piece onto inner vector
-      pieceVec[2].push_back(theBoard->boardVecs[i][j]);
+      pieceVec[2].push_back((*pieceGrid)[i][j]);
       pieceVec[2].back().pieceID = pieceCount;          // Set piece ID
       pieceCount++;                                     // Increment piece count
     }
@@ -659,12 +713,385 @@ void BoardManager::populatePieces(Board* theBoard)                     // *In*
 } // populatePieces()
 
 
+void BoardManager::buildPieceTable()
+{ // Builds the piece table from the piece vectors so the type and patterns
+  // of a packed piece can be looked up by ID. Called once after the pieces
+  // have been read or generated
+
+  PuzzlePiece blank = { 0, DEFAULT, 0, { 0, 0, 0, 0 } };  // Unused ID 0
+
+  // Piece IDs start at 1, so slot 0 of the table is never used
+  pieceTable.assign(pieceVec[CORNER].size() + pieceVec[EDGE].size() +
+                    pieceVec[INNER].size() + 1, blank);
+
+  for (int i = 0; i < (int)pieceVec.size(); i++)
+  { // Loop through each type of piece storing each piece under its ID
+    for (const PuzzlePiece& piece : pieceVec[i])
+    {
+      pieceTable[piece.pieceID] = piece;
+    }
+  }
+
+} // buildPieceTable()
+
+
+void BoardManager::buildColourIndex()
+{ // Builds the colour index from the piece vectors, storing every rotation of
+  // every piece under the colours it puts on the left and top. Called once
+  // after the pieces have been read or generated
+
+  PieceRef ref;           // Piece and rotation to store in the index
+  int left = -1;          // Colour on left of rotated piece
+  int top = -1;           // Colour on top of rotated piece
+
+  colourCount = 0;        // Reset in case index is rebuilt
+
+  for (int i = 0; i < (int)pieceVec.size(); i++)
+  { // Loop through each type of piece finding the highest colour ID
+    for (PuzzlePiece piece : pieceVec[i])
+    {
+      for (int j = 0; j < 4; j++)
+      { // Check each segment of the piece
+        if (piece.segments[j] + 1 > colourCount)
+        {
+          colourCount = piece.segments[j] + 1;
+        }
+      }
+    }
+  }
+
+  // Make an empty list for every type and pair of colours
+  colourIndex.assign(3 * colourCount * colourCount, std::vector<PieceRef>());
+
+  for (int i = 0; i < (int)pieceVec.size(); i++)
+  { // Loop through each type of piece
+    for (PuzzlePiece piece : pieceVec[i])
+    { // Loop through each piece adding all four rotations to the index
+
+      for (int orien = 0; orien < 4; orien++)
+      { // Colours the rotation puts on the left and top
+        left = getSegment(piece.pieceID, orien, LEFT);
+        top = getSegment(piece.pieceID, orien, TOP);
+
+        ref.pieceID = piece.pieceID;
+        ref.orientation = orien;
+
+        colourIndex[getColourKey(piece.type, left, top)].push_back(ref);
+      }
+    }
+  }
+
+} // buildColourIndex()
+
+
+std::vector<PieceRef>* BoardManager::getColourMatches(int type,        // *In*
+                                                      int left,        // *In*
+                                                      int top)         // *In*
+{ // Returns the pieces and rotations of the type given that have the left and
+  // top colours given, nullptr if the colours are not in the index
+
+  std::vector<PieceRef>* result = nullptr;    // Holds the list found
+
+  if (type >= CORNER && type <= INNER && left >= 0 && top >= 0 &&
+      left < colourCount && top < colourCount)
+  { // If the key is within the index, return the list
+    result = &colourIndex[getColourKey(type, left, top)];
+  }
+
+  return result;          // Return the list of pieces
+
+} // getColourMatches()
+
+
+int BoardManager::getColourKey(int type,                               // *In*
+                               int left,                               // *In*
+                               int top)                                // *In*
+{ // Returns the index in to the colour index for the piece type and the
+  // colours on the left and top of a rotated piece
+
+  return (type * colourCount + left) * colourCount + top;
+
+} // getColourKey()
+
+
+void BoardManager::buildZobristTable()
+{ // Fills the Zobrist table with a random key for every slot, piece and
+  // rotation. Uses a fixed seed so hashes are the same between runs
+
+  std::mt19937_64 keyGen(0x45544552u);  // 64 bit keys, fixed seed
+
+  // Piece IDs run from 1 up to the total number of pieces, so the table has
+  // room for one more piece ID than there are pieces. There is one slot for
+  // every piece so the board size is not needed yet
+  zobristPieces = (int)(pieceVec[CORNER].size() + pieceVec[EDGE].size() +
+                        pieceVec[INNER].size()) + 1;
+
+  zobristTable.resize((size_t)(zobristPieces - 1) * zobristPieces * 4);
+
+  for (size_t i = 0; i < zobristTable.size(); i++)
+  { // Give every slot, piece and rotation a random key
+    zobristTable[i] = keyGen();
+  }
+
+} // buildZobristTable()
+
+
+void BoardManager::hashBoard(Board* theBoard)                         // *In-Out*
+{ // Works out the Zobrist hash of the whole board and stores it in the board
+
+  theBoard->hash = 0;
+
+  for (int i = 0; i <= boardSize; i++)
+  { // Loop through each column of the board
+    for (int j = 0; j <= boardSize; j++)
+    { // XOR in the key of each piece and rotation in its slot
+      theBoard->hash ^= getZobrist(i, j, theBoard->boardVecs[i][j].pieceID,
+                                   theBoard->boardVecs[i][j].orientation);
+    }
+  }
+
+} // hashBoard()
+
+
+int BoardManager::findCanonicalTurn(Board* theBoard,                  // *In*
+                                    unsigned long long* canonHash)    // *Out*
+{ // Returns how many quarter turns clockwise give the board its smallest
+  // Zobrist hash, storing that hash in canonHash. Boards are never turned
+  // while pieces are locked, as the turned copies could not be made
+
+  unsigned long long hashes[4] = { 0, 0, 0, 0 };  // Hash of each turn
+  int turn = 0;                     // Turn with the smallest hash
+
+  if (!locks.empty())
+  { // Locked pieces fix the board in one turn
+    *canonHash = theBoard->hash;
+    return 0;
+  }
+
+  for (int i = 0; i <= boardSize; i++)
+  { // Loop through each column of the board
+    for (int j = 0; j <= boardSize; j++)
+    { // A quarter turn clockwise moves slot (i, j) to (size - j, i) and turns
+      // the piece in it once more, XOR the key of each turn in
+
+      const PackedPiece& piece = theBoard->boardVecs[i][j];
+
+      hashes[0] ^= getZobrist(i, j, piece.pieceID, piece.orientation);
+      hashes[1] ^= getZobrist(boardSize - j, i, piece.pieceID,
+                              (piece.orientation + 1) % 4);
+      hashes[2] ^= getZobrist(boardSize - i, boardSize - j, piece.pieceID,
+                              (piece.orientation + 2) % 4);
+      hashes[3] ^= getZobrist(j, boardSize - i, piece.pieceID,
+                              (piece.orientation + 3) % 4);
+    }
+  }
+
+  for (int i = 1; i < 4; i++)
+  { // Keep the turn with the smallest hash
+    if (hashes[i] < hashes[turn])
+    {
+      turn = i;
+    }
+  }
+
+  *canonHash = hashes[turn];
+
+  return turn;                      // Return the quarter turns needed
+
+} // findCanonicalTurn()
+
+
+unsigned long long BoardManager::getCanonicalHash(Board* theBoard)    // *In*
+{ // Returns the smallest Zobrist hash of the board over its four quarter
+  // turns, so a board and its turned copies share one hash. Used to tell
+  // distinct boards and solutions apart, the board hash itself is unchanged
+
+  unsigned long long canonHash = 0; // Smallest hash of the turns
+
+  findCanonicalTurn(theBoard, &canonHash);
+
+  return canonHash;                 // Return the canonical hash
+
+} // getCanonicalHash()
+
+
+void BoardManager::canonicalise(Board* theBoard)                     // *In-Out*
+{ // Turns the board to the quarter turn with the smallest Zobrist hash and
+  // rehashes it, so every turn of a solution is stored the same way
+
+  unsigned long long canonHash = 0; // Smallest hash of the turns
+  int turn = findCanonicalTurn(theBoard, &canonHash);  // Quarter turns needed
+  std::vector<std::vector<PackedPiece>> turned;  // Board after turning
+
+  for (int t = 0; t < turn; t++)
+  { // Turn the board a quarter clockwise at a time
+    turned = theBoard->boardVecs;
+
+    for (int i = 0; i <= boardSize; i++)
+    { // Move each piece to its slot after the turn and turn it with the board
+      for (int j = 0; j <= boardSize; j++)
+      {
+        turned[boardSize - j][i] = theBoard->boardVecs[i][j];
+        turned[boardSize - j][i].orientation =
+          (theBoard->boardVecs[i][j].orientation + 1) % 4;
+      }
+    }
+
+    theBoard->boardVecs.swap(turned);
+  }
+
+  theBoard->hash = canonHash;       // Hash of the turned board
+
+} // canonicalise()
+
+
+void BoardManager::addLock(int pieceID,                                // *In*
+                           int xIndex,                                 // *In*
+                           int yIndex,                                 // *In*
+                           int orientation)                            // *In*
+{ // Adds a piece to be fixed in the slot given with the rotation given in
+  // every board. Checked against the pieces when the locks are built
+
+  LockedSlot newLock;                  // Lock to add
+
+  newLock.pieceID = pieceID;           // Set piece ID
+  newLock.xIndex = xIndex;             // Set X index of slot
+  newLock.yIndex = yIndex;             // Set Y index of slot
+  newLock.orientation = orientation;   // Set rotation
+
+  locks.push_back(newLock);            // Store the lock
+
+} // addLock()
+
+
+void BoardManager::removeLock(int xIndex,                             // *In*
+                              int yIndex)                             // *In*
+{ // Removes the lock on the slot given if there is one. The free slots are
+  // only worked out again when the locks are next built
+
+  for (int i = (int)locks.size() - 1; i >= 0; i--)
+  { // Loop through each lock from the back, erasing any on the slot
+    if (locks[i].xIndex == xIndex && locks[i].yIndex == yIndex)
+    {
+      locks.erase(locks.begin() + i);
+    }
+  }
+
+} // removeLock()
+
+
+void BoardManager::lockStartPiece()
+{ // Locks the Eternity II start piece in slot [7][8] unless a hint in the
+  // puzzle file has already placed it
+
+  bool isHinted = false;               // Holds if a hint places start piece
+
+  for (const LockedSlot& lock : locks)
+  { // Check whether a hint already uses the start piece or its slot
+    if (lock.pieceID == STARTPIECE ||
+        (lock.xIndex == STARTX && lock.yIndex == STARTY))
+    {
+      isHinted = true;
+    }
+  }
+
+  if (!isHinted)
+  { // If no hint covers the start piece, lock it with the default rotation
+    addLock(STARTPIECE, STARTX, STARTY, STARTORIEN);
+  }
+
+} // lockStartPiece()
+
+
+void BoardManager::buildLocks()
+{ // Checks the locks against the pieces and board size, dropping any that
+  // cannot be placed, then works out the free slots and regions used for
+  // sampling. Called after the pieces and board size are known, and again
+  // whenever locks are added or removed
+
+  std::vector<LockedSlot> valid;       // Locks that can be placed
+  bool isFree = true;                  // Holds if a region has no lock
+
+  slotLocked.assign((boardSize + 1) * (boardSize + 1), false);
+  pieceLocked.assign(pieceTable.size(), false);
+
+  for (LockedSlot lock : locks)
+  { // Keep each lock whose piece exists, whose slot is on the board and
+    // holds the same type of piece, and that does not clash with another lock
+
+    bool isValid = lock.pieceID > 0 && lock.pieceID < (int)pieceTable.size() &&
+                   lock.xIndex >= 0 && lock.xIndex <= boardSize &&
+                   lock.yIndex >= 0 && lock.yIndex <= boardSize &&
+                   lock.orientation >= 0 && lock.orientation <= 3;
+
+    if (isValid)
+    { // Check the piece is the type of piece the slot holds
+      isValid = pieceTable[lock.pieceID].type ==
+                  getSlotType(lock.xIndex, lock.yIndex) &&
+                !pieceLocked[lock.pieceID] &&
+                !slotLocked[lock.xIndex * (boardSize + 1) + lock.yIndex];
+    }
+
+    if (isValid)
+    { // Border slots force the rotation, then mark the slot and piece
+      PackedPiece rotated;
+      rotated.pieceID = lock.pieceID;
+      rotated.orientation = lock.orientation;
+      fixOrien(&rotated, lock.xIndex, lock.yIndex);
+      lock.orientation = rotated.orientation;
+
+      slotLocked[lock.xIndex * (boardSize + 1) + lock.yIndex] = true;
+      pieceLocked[lock.pieceID] = true;
+      valid.push_back(lock);
+    }
+    else
+    { // Tell the user the lock has been dropped
+      std::cout << "Ignoring locked piece " << lock.pieceID << " at ["
+                << lock.xIndex << "][" << lock.yIndex << "]" << std::endl;
+    }
+  }
+
+  locks = valid;                       // Only keep the locks that can be used
+
+  for (int i = 0; i < 3; i++)
+  { // Empty the free slot lists ready to be refilled
+    freeSlots[i].clear();
+  }
+
+  freeRegions.clear();
+
+  for (int i = 0; i <= boardSize; i++)
+  { // X index of slot
+    for (int j = 0; j <= boardSize; j++)
+    { // Y index of slot
+
+      if (!slotLocked[i * (boardSize + 1) + j])
+      { // If slot is free, add it to the list for its type
+        freeSlots[getSlotType(i, j)].push_back(i * (boardSize + 1) + j);
+      }
+
+      if (i >= 1 && i <= boardSize - 2 && j >= 1 && j <= boardSize - 2)
+      { // If slot is the top left of a 2 x 2 inner region, check the region
+        isFree = !slotLocked[i * (boardSize + 1) + j] &&
+                 !slotLocked[(i + 1) * (boardSize + 1) + j] &&
+                 !slotLocked[i * (boardSize + 1) + j + 1] &&
+                 !slotLocked[(i + 1) * (boardSize + 1) + j + 1];
+
+        if (isFree)
+        { // If no slot of the region is locked, add it to the free regions
+          freeRegions.push_back(i * (boardSize + 1) + j);
+        }
+      }
+    }
+  }
+
+} // buildLocks()
+
+
 BoardManager::~BoardManager()
-{ // Destructor to delete the instance of the class
+{ // Destructor to release the populations
 
   currBoards = nullptr;     // Delete current generation
   prevBoards = nullptr;     // Delete previous generation
-  delete pInstance;         // Delete instance
-  pInstance = nullptr;      // Null instance
 
 } // ~BoardManager()
\ No newline at end of file
@@ -11,6 +11,11 @@
 #include <memory>               // Shared pointers
 
 
+#define STARTPIECE 139          // ID of the Eternity II start piece
+#define STARTX 7                // X index of the start piece slot
+#define STARTY 8                // Y index of the start piece slot
+#define STARTORIEN 0            // Rotation of the start piece when no hint
+
 // Enum so the code can use colours for the tile pieces
 enum segLocation { TOP, RIGHT, BOTTOM, LEFT };
 
@@ -30,6 +35,39 @@ struct PuzzlePiece
 }; // PuzzlePiece
 
 
+struct PackedPiece
+{ // Holds a piece placed in a board slot packed in to one 32 bit word, the ID
+  // of the piece and its rotation. The type and patterns of the piece are
+  // looked up in the piece table of the board manager using the ID
+
+  unsigned int pieceID : 30;      // Holds the ID of the puzzle piece
+  unsigned int orientation : 2;   // Holds the rotation of the puzzle piece
+
+}; // PackedPiece
+
+
+struct PieceRef
+{ // Holds a piece along with the rotation that puts the colours looked up in
+  // the colour index on the left and top of the piece
+
+  int pieceID;      // Holds the ID of the puzzle piece
+  int orientation;  // Holds the rotation of the puzzle piece
+
+}; // PieceRef
+
+
+struct LockedSlot
+{ // Holds a piece that is fixed in a slot of every board, such as the start
+  // piece or a hint piece given in the puzzle file
+
+  int pieceID;      // Holds the ID of the locked piece
+  int xIndex;       // Holds the X index of the slot the piece is locked to
+  int yIndex;       // Holds the Y index of the slot the piece is locked to
+  int orientation;  // Holds the rotation the piece is locked to
+
+}; // LockedSlot
+
+
 struct Board
 { // Holds the data needed for the board, this includes the fitness score of
   // the board, the ID of the board and the location of the pieces within the
@@ -38,12 +76,13 @@ struct Board
   int fitScore;       // Holds fitness score for the board
   int matchCount;     // Holds how many pattern matches are in board
   int boardID;        // Holds the ID of the board
+  unsigned long long hash;  // Zobrist hash of the pieces and rotations
   
   // Vector of all pieces within board
-  std::vector<std::vector<PuzzlePiece>> boardVecs;
+  std::vector<std::vector<PackedPiece>> boardVecs;
 
   // Overrides the less than operator for sorting to sort by fitness
-  bool operator < (const Board theBoard) const
+  bool operator < (const Board& theBoard) const
   {
     
     bool result = false;
@@ -71,20 +110,61 @@ class BoardManager
 private:
   int patternNum;                     // Amount of patterns within board
   int boardSize;                      // Holds the size of the board
-  static BoardManager* pInstance;     // Current instance of class
+  int edgeColour;                     // Colour facing the board edge
 
   // Collection of all pieces to be used split into corner, edge and inner types
   std::vector<std::vector<PuzzlePiece>> pieceVec;
 
+  // Every piece indexed by piece ID, for looking up the type and patterns of
+  // the packed pieces held in boards
+  std::vector<PuzzlePiece> pieceTable;
+
+  // Pieces and rotations keyed by piece type, left colour and top colour
+  std::vector<std::vector<PieceRef>> colourIndex;
+  int colourCount;                    // Highest colour ID in index + 1
+
+  // Random key for every slot, piece and rotation, XORed together to hash
+  std::vector<unsigned long long> zobristTable;
+  int zobristPieces;                  // Piece IDs the table covers, from 0
+
+  // Type of piece each slot holds, indexed by x * (boardSize + 1) + y
+  std::vector<unsigned char> slotTypes;
+
+  // Rotation that turns a corner or edge piece to the board edge in each
+  // border slot, indexed by x * (boardSize + 1) + y
+  std::vector<unsigned char> slotOriens;
+
+  // Pieces fixed in place in every board
+  std::vector<LockedSlot> locks;
+
+  // Whether each slot is locked, indexed by x * (boardSize + 1) + y
+  std::vector<bool> slotLocked;
+
+  // Whether each piece is locked, indexed by piece ID
+  std::vector<bool> pieceLocked;
+
+  // Slots that are not locked split into corner, edge and inner types, each
+  // stored as x * (boardSize + 1) + y
+  std::vector<std::vector<int>> freeSlots;
+
+  // Top left slots of the 2 x 2 inner regions that hold no locked slot
+  std::vector<int> freeRegions;
+
+  int ringScore;                      // Score of the locked border ring, -1
+                                      // if the border is not locked
+  int ringMatches;                    // Matches of the locked border ring
+  long long checkCount;               // Full fitness checks of the solver
+
+  // Mismatched edges of each slot summed over the population, indexed by
+  // x * (boardSize + 1) + y. Empty unless mismatch biased mutation is on
+  std::vector<int> heatmap;
+
   // Boards in current generation
   std::shared_ptr<std::vector<Board>> currBoards;
 
   // Board in previous generation
   std::shared_ptr<std::vector<Board>> prevBoards;
 
-  // Seeds rand() with time and initalises currBoards
-  BoardManager();
-
   // Initialises the top edge (not including corners) of the board read for
   // inner pieces to be inserted
   void initTopEdge(Board* theBoard);                       // *Out*  
@@ -97,23 +177,21 @@ private:
   // then finally filling in the corners, side edges and bottom edge
   void addPieces(Board* theBoard);                         // *Out*
 
-  // If an official Eternity II solve attempt, make sure the start piece
-  // constraint is met by placing the piece with the ID 139 on slot [7][8]
-  void fixStartPiece(Board* theBoard);                     // *Out*
+  // Works out the type of piece and the border rotation of every slot for
+  // the board size, so placing a border piece is a table lookup
+  void buildSlotTable();
 
-  // Swap the piece with the given index with the piece in the starting piece
-  // slot according to the Eternity II rule book. (Slot [7][8])
-  void swapStartPiece(Board* theBoard,                     // *Out*
-                      int xIndex,                          // *In*  
-                      int yIndex);                         // *In*
+  // Swaps every locked piece in to the slot it is locked to with the rotation
+  // it is locked to, fixing the rotation of any border piece moved out
+  void placeLocks(Board* theBoard);                        // *In-Out*
 
   // Rotates an edge piece so the edge pattern matches the edge of the board
-  void rotateEdge(PuzzlePiece* piece,                      // *Out*  
+  void rotateEdge(PackedPiece* piece,                      // *Out*  
                   int xIndex,                              // *In*
                   int yIndex);                             // *In*
 
   // Rotates an corner piece so the corner pattern matches the edge of the board
-  void rotateCorner(PuzzlePiece* piece,                    // *Out*
+  void rotateCorner(PackedPiece* piece,                    // *Out*
                     int xIndex,                            // *In*
                     int yIndex);                           // *In*
 
@@ -137,13 +215,27 @@ private:
   PuzzlePiece genInner(int pattern1,                       // *In*
                        int pattern2);                      // *In*
 
-  // Fill the piece vectors with the pieces located within the board given as
-  // the parameter
-  void populatePieces(Board* theBoard);                    // *In*
+  // Fill the piece vectors with the pieces located within the grid of
+  // generated pieces given as the parameter
+  void populatePieces(
+    std::vector<std::vector<PuzzlePiece>>* pieceGrid);     // *In*
+
+  // Returns the index in to the colour index for the piece type and the
+  // colours on the left and top of a rotated piece
+  int getColourKey(int type,                               // *In*
+                   int left,                               // *In*
+                   int top);                               // *In*
+
+  // Returns how many quarter turns clockwise give the board its smallest
+  // Zobrist hash, storing that hash in canonHash. Boards are never turned
+  // while pieces are locked, as the turned copies could not be made
+  int findCanonicalTurn(Board* theBoard,                   // *In*
+                        unsigned long long* canonHash);    // *Out*
 
 public:
-  // Returns the instance to the class, if none currently exists, creates one
-  static BoardManager* getInstance();
+  // Initialises currBoards with an empty population. Each solver owns its own
+  // board manager so several solvers can run in one process
+  BoardManager();
 
   // Returns the board size
   inline int getSize()
@@ -157,6 +249,23 @@ public:
     return &pieceVec;   // Return the piece vector of vectors
   } // getPieces()
 
+  // Returns the piece with the ID given from the piece table
+  inline PuzzlePiece* getPiece(int pieceID)
+  {
+    return &pieceTable[pieceID];   // Return the piece
+  } // getPiece()
+
+  // Packs the ID and rotation of the piece in to a board slot
+  inline PackedPiece packPiece(PuzzlePiece* piece)
+  {
+    PackedPiece packed;                        // Packed piece to return
+
+    packed.pieceID = piece->pieceID;           // Store piece ID
+    packed.orientation = piece->orientation;   // Store rotation
+
+    return packed;                             // Return the packed piece
+  } // packPiece()
+
   // Returns a pointer to the vector that holds the current population
   inline std::shared_ptr<std::vector<Board>> getPop()
   { 
@@ -169,20 +278,158 @@ public:
     return prevBoards;  // Return the previous population
   } // getOldPop()
 
-  // Switch the current population to the old population and create a new
-  // shared vector for the new population
+  // Switch the current population to the old population and reuse the
+  // population from two generations ago as storage for the new population
   void switchPop();
 
-  // Sets how many patterns to be used and how many pieces there are per board
+  // Sets how many patterns to be used and how many pieces there are per board.
+  // Called once the pieces have been loaded, so the edge colour can be read
   void initialiseData(int size,                            // *In*
                       int patNum);                         // *In*
 
   // Initialises the boards vector of vectors with empty vectors
   void initEmptyBoard(Board* theBoard);                    // *Out*
 
+  // Makes sure the board has a full column of slots for every column of the
+  // board, keeping any storage the board already has
+  void shapeBoard(Board* theBoard);                        // *In-Out*
+
   // Creates the inital board filled with randomised order of pieces
-  void initFullBoard(Board* theBoard,                      // *Out*
-                     bool startPiece);                     // *In*
+  void initFullBoard(Board* theBoard);                     // *Out*
+
+  // Refills a board that already has its columns with a new randomised order
+  // of pieces, reusing the storage of the columns
+  void refillBoard(Board* theBoard);                       // *In-Out*
+
+  // Adds a piece to be fixed in the slot given with the rotation given in
+  // every board. Checked against the pieces when the locks are built
+  void addLock(int pieceID,                                // *In*
+               int xIndex,                                 // *In*
+               int yIndex,                                 // *In*
+               int orientation);                           // *In*
+
+  // Removes the lock on the slot given if there is one. The free slots are
+  // only worked out again when the locks are next built
+  void removeLock(int xIndex,                              // *In*
+                  int yIndex);                             // *In*
+
+  // Locks the Eternity II start piece in slot [7][8] unless a hint in the
+  // puzzle file has already placed it
+  void lockStartPiece();
+
+  // Checks the locks against the pieces and board size, dropping any that
+  // cannot be placed, then works out the free slots and regions used for
+  // sampling. Called after the pieces and board size are known, and again
+  // whenever locks are added or removed
+  void buildLocks();
+
+  // Returns whether the slot given holds a locked piece
+  inline bool isLocked(int xIndex,                         // *In*
+                       int yIndex)                         // *In*
+  {
+    return slotLocked[xIndex * (boardSize + 1) + yIndex];  // Return if locked
+  } // isLocked()
+
+  // Returns whether the piece with the ID given is locked in to a slot
+  inline bool isPieceLocked(int pieceID)                   // *In*
+  {
+    return pieceLocked[pieceID];   // Return if locked
+  } // isPieceLocked()
+
+  // Returns the locked pieces
+  inline std::vector<LockedSlot>* getLocks()
+  {
+    return &locks;   // Return the locks
+  } // getLocks()
+
+  // Returns the slots of the type given that are not locked
+  inline std::vector<int>* getFreeSlots(int type)          // *In*
+  {
+    return &freeSlots[type];   // Return the free slots
+  } // getFreeSlots()
+
+  // Returns the top left slots of the 2 x 2 inner regions with no lock
+  inline std::vector<int>* getFreeRegions()
+  {
+    return &freeRegions;   // Return the free regions
+  } // getFreeRegions()
+
+  // Stores the score and matches of the edges between border slots once the
+  // whole border is locked, so fitness checks can skip those edges
+  inline void setRing(int score,                           // *In*
+                      int matches)                         // *In*
+  {
+    ringScore = score;       // Store the score of the ring
+    ringMatches = matches;   // Store the matches of the ring
+  } // setRing()
+
+  // Returns the score of the locked border ring, -1 if not locked
+  inline int getRingScore()
+  {
+    return ringScore;        // Return the score of the ring
+  } // getRingScore()
+
+  // Returns the matches of the locked border ring
+  inline int getRingMatches()
+  {
+    return ringMatches;      // Return the matches of the ring
+  } // getRingMatches()
+
+  // Adds the number of full fitness checks given to the count of the solver,
+  // so every object that checks fitness adds to the same evaluation budget
+  inline void addChecks(int count)                         // *In*
+  {
+    checkCount += count;     // Add the checks to the count
+  } // addChecks()
+
+  // Returns how many full fitness checks the solver has made
+  inline long long getCheckCount()
+  {
+    return checkCount;       // Return the checks made
+  } // getCheckCount()
+
+  // Sets every slot of the mismatch heatmap back to zero, ready to sum the
+  // mismatches of a new generation
+  inline void clearHeatmap()
+  {
+    heatmap.assign((boardSize + 1) * (boardSize + 1), 0);
+  } // clearHeatmap()
+
+  // Returns the mismatch heatmap of the population
+  inline std::vector<int>* getHeatmap()
+  {
+    return &heatmap;         // Return the heatmap
+  } // getHeatmap()
+
+  // Sets the 2 dimensional index of the free slot given
+  inline void getSlotIndex(int slot,                       // *In*
+                           int index[2])                   // *Out*
+  {
+    index[0] = slot / (boardSize + 1);   // X index
+    index[1] = slot % (boardSize + 1);   // Y index
+  } // getSlotIndex()
+
+  // Returns the type of piece the slot given holds, corner, edge or inner
+  inline PieceType getSlotType(int xIndex,                 // *In*
+                               int yIndex)                 // *In*
+  {
+    return (PieceType)slotTypes[xIndex * (boardSize + 1) + yIndex];
+  } // getSlotType()
+
+  // Returns the colour every border piece shows towards the board edge
+  inline int getEdgeColour()
+  {
+    return edgeColour;
+  } // getEdgeColour()
+
+  // Returns the pattern the piece with the ID given shows on the side given
+  // when turned to the orientation given
+  inline int getSegment(int pieceID,                       // *In*
+                        int orientation,                   // *In*
+                        int side)                          // *In*
+  {
+    return pieceTable[pieceID].segments[(side - orientation + 4) & 3];
+  } // getSegment()
 
   // Returns the ID of the pattern located on the piece with in the index 
   // provided taking into consideration the orientation of the piece
@@ -193,7 +440,7 @@ public:
 
   // Rotates the piece to match the edge of the board by setting the orientation
   // so that the edge pattern matches the edge of the board. 
-  void fixOrien(PuzzlePiece* piece,                        // *Out*
+  void fixOrien(PackedPiece* piece,                        // *Out*
                 int yIndex,                                // *In*
                 int xIndex);                               // *In*
 
@@ -202,7 +449,50 @@ public:
   void generateBoard(int size,                             // *In*
                      int pattern);                         // *In*
 
-  // Destructor to delete the instance of the class
+  // Builds the piece table from the piece vectors so the type and patterns
+  // of a packed piece can be looked up by ID. Called once after the pieces
+  // have been read or generated
+  void buildPieceTable();
+
+  // Builds the colour index from the piece vectors, storing every rotation of
+  // every piece under the colours it puts on the left and top. Called once
+  // after the pieces have been read or generated
+  void buildColourIndex();
+
+  // Returns the pieces and rotations of the type given that have the left and
+  // top colours given, nullptr if the colours are not in the index
+  std::vector<PieceRef>* getColourMatches(int type,        // *In*
+                                          int left,        // *In*
+                                          int top);        // *In*
+
+  // Fills the Zobrist table with a random key for every slot, piece and
+  // rotation. Uses a fixed seed so hashes are the same between runs
+  void buildZobristTable();
+
+  // Returns the Zobrist key for the piece placed in the slot with the rotation
+  // given. XOR the key out and back in to update a hash when a slot changes
+  inline unsigned long long getZobrist(int xIndex,         // *In*
+                                       int yIndex,         // *In*
+                                       int pieceID,        // *In*
+                                       int orientation)    // *In*
+  {
+    return zobristTable[(((size_t)xIndex * (boardSize + 1) + yIndex) *
+                         zobristPieces + pieceID) * 4 + orientation];
+  } // getZobrist()
+
+  // Works out the Zobrist hash of the whole board and stores it in the board
+  void hashBoard(Board* theBoard);                         // *In-Out*
+
+  // Returns the smallest Zobrist hash of the board over its four quarter
+  // turns, so a board and its turned copies share one hash. Used to tell
+  // distinct boards and solutions apart, the board hash itself is unchanged
+  unsigned long long getCanonicalHash(Board* theBoard);    // *In*
+
+  // Turns the board to the quarter turn with the smallest Zobrist hash and
+  // rehashes it, so every turn of a solution is stored the same way
+  void canonicalise(Board* theBoard);                      // *In-Out*
+
+  // Destructor to release the populations
   ~BoardManager();
 
 }; // BoardManager
@@ -0,0 +1,304 @@
+// Title        : BorderSolver.cpp
+// Purpose      : Solves the border ring alone before the inner pieces
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#include "BorderSolver.h"       // Class declaration
+#include <algorithm>            // random_shuffle()
+
+
+BorderSolver::BorderSolver(BoardManager* manager)           // *In*
+{ // Stores the board manager of the solver
+
+  boardMan = manager;               // Board manager of the solver
+  bestDepth = 0;                    // No ring matched yet
+  nodes = 0;                        // No placements tried yet
+
+} // BorderSolver()
+
+
+void BorderSolver::buildRing()
+{ // Builds the list of border slots in clockwise order starting from the
+  // top left corner, and the free corner and edge pieces that can fill them
+
+  int size = boardMan->getSize();                      // Last index of board
+
+  ring.clear();
+  candidates.assign(2, std::vector<int>());
+
+  for (int i = 0; i < size; i++)
+  { // Top edge, left to right
+    ring.push_back({ i, 0 });
+  }
+
+  for (int j = 0; j < size; j++)
+  { // Right edge, top to bottom
+    ring.push_back({ size, j });
+  }
+
+  for (int i = size; i > 0; i--)
+  { // Bottom edge, right to left
+    ring.push_back({ i, size });
+  }
+
+  for (int j = size; j > 0; j--)
+  { // Left edge, bottom to top
+    ring.push_back({ 0, j });
+  }
+
+  for (int type = CORNER; type <= EDGE; type++)
+  { // Store every border piece that is not locked in to a slot
+    for (const PuzzlePiece& piece : (*boardMan->getPieces())[type])
+    {
+      if (!boardMan->isPieceLocked(piece.pieceID))
+      {
+        candidates[type].push_back(piece.pieceID);
+      }
+    }
+  }
+
+} // buildRing()
+
+
+bool BorderSolver::isRingMatch(Board* theBoard,             // *In*
+                               int depth)                   // *In*
+{ // Returns whether the piece in the ring slot given matches the piece in the
+  // slot before it, and for the last slot also the first slot of the ring.
+  // Only the edges between border slots are checked
+
+  bool result = true;               // Holds if the piece matches
+  int other = depth - 1;            // Ring slot being compared against
+  int xStep = 0;                    // X step from the other slot
+  int yStep = 0;                    // Y step from the other slot
+  segLocation side = TOP;           // Side of the other slot facing this slot
+
+  for (int pass = 0; pass < 2 && result; pass++)
+  { // Check the slot before, then the first slot if this closes the ring
+
+    if (pass == 1)
+    { // Only the last slot of the ring touches the first
+      if (depth != (int)ring.size() - 1)
+      {
+        break;
+      }
+      other = 0;
+    }
+
+    if (other < 0)
+    { // The first slot has nothing placed before it
+      continue;
+    }
+
+    xStep = ring[depth][0] - ring[other][0];
+    yStep = ring[depth][1] - ring[other][1];
+
+    // Side of the other slot that faces this slot
+    side = (xStep == 1) ? RIGHT : (xStep == -1) ? LEFT :
+           (yStep == 1) ? BOTTOM : TOP;
+
+    result = boardMan->getPattern(theBoard, ring[other][0], ring[other][1],
+                                  side) ==
+             boardMan->getPattern(theBoard, ring[depth][0], ring[depth][1],
+                                  (segLocation)((side + 2) % 4));
+  }
+
+  return result;                    // Return whether the piece matches
+
+} // isRingMatch()
+
+
+bool BorderSolver::placeNext(Board* theBoard,               // *In-Out*
+                             int depth)                     // *In*
+{ // Places a piece in the ring slot given and carries on round the ring,
+  // undoing the placement if the rest of the ring can not be matched.
+  // Returns whether the ring was closed
+
+  int xIndex = -1;                  // X index of the slot
+  int yIndex = -1;                  // Y index of the slot
+  int type = -1;                    // Type of piece the slot holds
+  bool isClosed = false;            // Holds if the ring was closed
+
+  if (depth > bestDepth)
+  { // Remember the longest matched ring in case the search runs out
+    bestDepth = depth;
+
+    for (int i = 0; i < depth; i++)
+    {
+      bestRing[i] = theBoard->boardVecs[ring[i][0]][ring[i][1]];
+    }
+  }
+
+  if (depth == (int)ring.size())
+  { // Every slot matched, the ring is closed
+    return true;
+  }
+
+  if (nodes >= RINGNODES)
+  { // Give up this attempt
+    return false;
+  }
+
+  xIndex = ring[depth][0];
+  yIndex = ring[depth][1];
+
+  if (boardMan->isLocked(xIndex, yIndex))
+  { // Locked slots already hold their piece, only check it matches
+    nodes++;
+    return isRingMatch(theBoard, depth) && placeNext(theBoard, depth + 1);
+  }
+
+  // Corners of the ring hold corner pieces, the rest hold edge pieces
+  type = boardMan->getSlotType(xIndex, yIndex);
+
+  for (int i = 0; i < (int)candidates[type].size() && !isClosed &&
+                  nodes < RINGNODES; i++)
+  { // Try each unused piece of the type, its rotation is fixed by the slot
+
+    if (isUsed[candidates[type][i]])
+    {
+      continue;
+    }
+
+    nodes++;
+
+    theBoard->boardVecs[xIndex][yIndex].pieceID = candidates[type][i];
+    boardMan->fixOrien(&theBoard->boardVecs[xIndex][yIndex], xIndex, yIndex);
+
+    if (isRingMatch(theBoard, depth))
+    { // If the piece matches, mark it used and carry on round the ring
+      isUsed[candidates[type][i]] = true;
+      isClosed = placeNext(theBoard, depth + 1);
+
+      if (!isClosed)
+      { // Rest of the ring could not be matched, free the piece again
+        isUsed[candidates[type][i]] = false;
+      }
+    }
+  }
+
+  return isClosed;                  // Return whether the ring was closed
+
+} // placeNext()
+
+
+void BorderSolver::fillRest(Board* theBoard)                // *In-Out*
+{ // Fills the ring slots after the best depth reached with the pieces that
+  // were not used, so the border holds every border piece once
+
+  int type = -1;                    // Type of piece the slot holds
+  int next[2] = { 0, 0 };           // Next unused piece of each type
+
+  std::fill(isUsed.begin(), isUsed.end(), false);
+
+  for (int i = 0; i < bestDepth; i++)
+  { // Put the best ring back and mark its pieces used
+    theBoard->boardVecs[ring[i][0]][ring[i][1]] = bestRing[i];
+    isUsed[bestRing[i].pieceID] = true;
+  }
+
+  for (int i = bestDepth; i < (int)ring.size(); i++)
+  { // Fill the rest of the ring with the unused pieces of the right type
+
+    if (boardMan->isLocked(ring[i][0], ring[i][1]))
+    { // Locked slots already hold their piece
+      continue;
+    }
+
+    type = boardMan->getSlotType(ring[i][0], ring[i][1]);
+
+    while (isUsed[candidates[type][next[type]]])
+    { // Skip pieces already in the ring
+      next[type]++;
+    }
+
+    theBoard->boardVecs[ring[i][0]][ring[i][1]].pieceID =
+      candidates[type][next[type]];
+    boardMan->fixOrien(&theBoard->boardVecs[ring[i][0]][ring[i][1]],
+                       ring[i][0], ring[i][1]);
+    isUsed[candidates[type][next[type]]] = true;
+  }
+
+} // fillRest()
+
+
+bool BorderSolver::solve(Board* theBoard)                   // *In-Out*
+{ // Searches for an arrangement of the border pieces where every edge between
+  // two border slots matches, leaving the ring in the border of the board
+  // given. Falls back to the longest matched ring found if the search runs
+  // out of attempts. Returns whether the whole ring matched
+
+  bool isClosed = false;            // Holds if the ring was closed
+
+  buildRing();
+
+  bestDepth = 0;
+  bestRing.assign(ring.size(), PackedPiece());
+  isUsed.assign((*boardMan->getPieces())[CORNER].size() +
+                (*boardMan->getPieces())[EDGE].size() +
+                (*boardMan->getPieces())[INNER].size() + 1, false);
+
+  for (int i = 0; i < RINGATTEMPTS && !isClosed; i++)
+  { // Each attempt tries the pieces in a new random order
+
+    std::random_shuffle(candidates[CORNER].begin(), candidates[CORNER].end());
+    std::random_shuffle(candidates[EDGE].begin(), candidates[EDGE].end());
+
+    std::fill(isUsed.begin(), isUsed.end(), false);
+    nodes = 0;
+
+    isClosed = placeNext(theBoard, 0);
+  }
+
+  if (!isClosed)
+  { // Use the longest matched ring found, filling the rest in any order
+    fillRest(theBoard);
+  }
+
+  boardMan->hashBoard(theBoard);    // Border changed, rehash the board
+
+  return isClosed;                  // Return whether the ring was closed
+
+} // solve()
+
+
+void BorderSolver::lockBorder(Board* theBoard)              // *In*
+{ // Locks every border slot of the board given that is not already locked,
+  // so later phases only move inner pieces
+
+  for (const std::vector<int>& slot : ring)
+  { // Add a lock for each border slot with the piece and rotation it holds
+
+    if (!boardMan->isLocked(slot[0], slot[1]))
+    { // Note the slot so the lock can be removed again on a restart
+      boardMan->addLock(theBoard->boardVecs[slot[0]][slot[1]].pieceID,
+                        slot[0], slot[1],
+                        theBoard->boardVecs[slot[0]][slot[1]].orientation);
+      lockedSlots.push_back(slot);
+    }
+  }
+
+  boardMan->buildLocks();           // Work out the free inner slots again
+
+} // lockBorder()
+
+
+void BorderSolver::unlockBorder()
+{ // Removes the locks added by the last locked ring and forgets its score,
+  // leaving any locks from the puzzle file in place
+
+  if (lockedSlots.empty())
+  { // Nothing locked, locks are already as the puzzle file left them
+    return;
+  }
+
+  for (const std::vector<int>& slot : lockedSlots)
+  { // Remove the lock of each slot the ring locked
+    boardMan->removeLock(slot[0], slot[1]);
+  }
+
+  lockedSlots.clear();
+  boardMan->buildLocks();           // Work out the free border slots again
+  boardMan->setRing(-1, 0);         // Fitness checks score the border again
+
+} // unlockBorder()
\ No newline at end of file
@@ -0,0 +1,69 @@
+// Title        : BorderSolver.h
+// Purpose      : Solves the border ring alone before the inner pieces
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#define RINGNODES 2000000       // Placements tried per attempt at the ring
+#define RINGATTEMPTS 20         // Attempts with a new piece order
+
+
+#include "BoardManager.h"       // Pieces, locks and board definition
+#include <vector>               // Ring order and candidate pieces
+
+
+class BorderSolver
+{
+
+private:
+  BoardManager* boardMan;                     // Board manager of the solver
+  std::vector<std::vector<int>> ring;         // Border slots, clockwise
+  std::vector<std::vector<int>> candidates;   // Free corner and edge IDs
+  std::vector<bool> isUsed;                   // Whether piece is in the ring
+  std::vector<PackedPiece> bestRing;          // Longest matched ring found
+  std::vector<std::vector<int>> lockedSlots;  // Slots locked by the ring
+  int bestDepth;                              // Slots matched in best ring
+  long long nodes;                            // Placements this attempt
+
+  // Builds the list of border slots in clockwise order starting from the
+  // top left corner, and the free corner and edge pieces that can fill them
+  void buildRing();
+
+  // Returns whether the piece in the ring slot given matches the piece in the
+  // slot before it, and for the last slot also the first slot of the ring.
+  // Only the edges between border slots are checked
+  bool isRingMatch(Board* theBoard,                     // *In*
+                   int depth);                          // *In*
+
+  // Places a piece in the ring slot given and carries on round the ring,
+  // undoing the placement if the rest of the ring can not be matched.
+  // Returns whether the ring was closed
+  bool placeNext(Board* theBoard,                       // *In-Out*
+                 int depth);                            // *In*
+
+  // Fills the ring slots after the best depth reached with the pieces that
+  // were not used, so the border holds every border piece once
+  void fillRest(Board* theBoard);                       // *In-Out*
+
+public:
+  // Stores the board manager of the solver
+  BorderSolver(BoardManager* manager);                  // *In*
+
+  // Searches for an arrangement of the border pieces where every edge between
+  // two border slots matches, leaving the ring in the border of the board
+  // given. Falls back to the longest matched ring found if the search runs
+  // out of attempts. Returns whether the whole ring matched
+  bool solve(Board* theBoard);                          // *In-Out*
+
+  // Locks every border slot of the board given that is not already locked,
+  // so later phases only move inner pieces
+  void lockBorder(Board* theBoard);                     // *In*
+
+  // Removes the locks added by the last locked ring and forgets its score,
+  // leaving any locks from the puzzle file in place
+  void unlockBorder();
+
+}; // BorderSolver
\ No newline at end of file
@@ -10,82 +10,379 @@
 #include <algorithm>            // Sorting functionality
 
 
-Crossover::Crossover()
-{ // Sets tournament size, initalise methods to default
+Crossover::Crossover(BoardManager* manager)                     // *In*
+{ // Sets tournament size, initalise methods to default and stores the board
+  // manager of the solver
 
   tournamentSize = 10;     // Set tournament size to 10
   crossType = TWOPOINT;    // Set default crossover to two point
   selectType = TOURNAMENT; // Set default selection to tournament
   eliteRate = 2;           // Set default elitism rate to 2
+  rejectCount = 0;         // No offspring rejected yet
+  retries = 0;             // No pair bred again yet
+  totalFitness = 0;        // No fitness loaded yet
+  boardMan = manager;      // Board manager of the solver
+
+  draws.resize(tournamentSize);  // Room for every contestant
 
 } // Crossover()
 
 
 void Crossover::setMethod(CrossoverType cross,                        // *In*
                           SelectionType select,                       // *In*
-                          int elite)                                  // *In*
+                          int elite,                                  // *In*
+                          int tournament)                             // *In*
 { // Sets the crossover and selection type to use for crossover along with
-  // the elitism rate
+  // the elitism rate and tournament size
 
   crossType = cross;    // Set the crossover method
   selectType = select;  // Srt the selection method
   eliteRate = elite;    // Set the elitism rate
+  tournamentSize = tournament;   // Set the tournament size
+
+  draws.resize(tournamentSize);  // Room for every contestant
 
 } // setMethod()
 
 
-void Crossover::doCrossover(int popSize)                              // *In*                           
+void Crossover::doCrossover(int popSize)                              // *In*
 { // Selects the parent candidates then commences with crossover with chosen
   // methods
 
-  int totalFitness = 0;      // Holds the combined fitness of all boards
   int popCount = 0;          // Holds how many offspring have been created
+  Board* offspring[2];       // Two slots of new population to breed in to
+
+  // Holds how many offspring will be created
+  int offspringCount = beginGeneration(popSize);
+
+  while (popCount < offspringCount)
+  { // While the new vector is not filled with the right population size
+    // make more candidates
+
+    if (breedPair(popSize, popCount, offspring))
+    { // If the pair was accepted, increment offspring count by 2
+      popCount += 2;
+    }
+  }
+
+  doElitism(popCount); // Transfer the elites over to new generation
+
+} // doCrossover()
+
+
+int Crossover::beginGeneration(int popSize)                           // *In*
+{ // Gets ready to breed a new generation from the previous one, sizing the
+  // new population. Returns how many offspring are bred before the elites
+
+  int offspringCount = 0;    // Holds how many offspring will be created
+
+  popHashes.clear();         // New population starts with no offspring
+  rejectCount = 0;           // Reset count of rejected offspring
+  retries = 0;               // First pair starts with no retries
+
+  // Parents come from the previous generation
+  selectPop = boardMan->getOldPop();
+
+  // Copy the fitness of the previous generation for selection, working out
+  // the total fitness now so not working out the total fitness every select
+  loadFitness(popSize);
+
+  while (offspringCount < popSize - (eliteRate * 2) - 1)
+  { // Work out how many offspring are made, offspring are made in pairs
+    offspringCount += 2;
+  }
+
+  // Size the new population, reusing the boards already in the vector
+  boardMan->getPop()->resize(offspringCount + (eliteRate * 2));
+
+  if (selectType == CROWDING)
+  { // If using crowding, pair the boards up for the whole generation
+    shuffleCrowd(popSize);
+    crowdRivals.resize(offspringCount);
+  }
+
+  return offspringCount;     // Return how many offspring to breed
+
+} // beginGeneration()
+
+
+bool Crossover::breedPair(int popSize,                                // *In*
+                          int popCount,                               // *In*
+                          Board* offspring[2])                        // *Out*
+{ // Breeds the next pair of the generation in to the two slots of the new
+  // population from the index given, setting offspring to point to them.
+  // Returns false if the pair was a copy and has to be bred again
+
   Board* parents[2];         // Two boards that have been selected as parents
+  Board* rivals[2];          // Parent each child faces when crowding
+  unsigned long long canonHashes[2];  // Hashes of any turn of the pair
 
-  if (selectType == ROULETTE)
-  { // If using roulette method, work out the total fitness now so not working
-    // out the total fitness every select
-    for (Board i : *BoardManager::getInstance()->getOldPop())
-    { // Loops through all boards and total up all fitness scores from boards
-      totalFitness += i.fitScore;   // Add fitness to total
+  if (selectType == CROWDING)
+  { // Crowding breeds each board with the board next to it in the shuffle
+    parents[0] = &selectPop->at(crowdOrder[popCount]);
+    parents[1] = &selectPop->at(crowdOrder[popCount + 1]);
+  }
+  else
+  { // Otherwise select two different parents
+    selectParents(parents, popSize);
+  }
+
+  for (int i = 0; i < 2; i++)
+  { // Breed in to the next two slots of the new population
+    offspring[i] = &boardMan->getPop()->at(popCount + i);
+    offspring[i]->boardID = popCount + i + 1;
+  }
+
+  reproduce(parents, offspring);  // Breed the parents together
+  checkDuplication(offspring);    // Check for any duplicate pieces
+
+  if (isDuplicatePair(offspring, canonHashes) && retries < DEDUPRETRIES)
+  { // If either offspring is a copy of one already made, breed again in to
+    // the same slots so the slots are not wasted on a copy
+    rejectCount += 2;
+    retries++;
+    return false;
+  }
+
+  if (selectType == CROWDING)
+  { // Match each child with the parent it competes with once it is scored
+    matchRivals(parents, offspring, rivals);
+
+    for (int i = 0; i < 2; i++)
+    { // Store the previous generation index of each rival
+      crowdRivals[popCount + i] = (int)(rivals[i] - &selectPop->at(0));
     }
   }
 
-  while (popCount < popSize -(eliteRate * 2) - 1)
-  { // While the new vector is not filled with the right population size
-    // make more candidates
+  for (int i = 0; i < 2; i++)
+  { // Store the canonical hashes of the accepted pair
+    popHashes.insert(canonHashes[i]);
+  }
+
+  retries = 0;               // Next pair starts with no retries
+
+  return true;               // Pair accepted
+
+} // breedPair()
+
+
+void Crossover::beginSteadyState(int popSize)                         // *In*
+{ // Selects parents from the current population from now on for steady
+  // state mode, loading the fitness of the population for selection and
+  // building the worst heap for replacement
+
+  // Parents come from the current population as it is replaced in place
+  selectPop = boardMan->getPop();
+
+  loadFitness(popSize);      // Copy the fitness of the population
+  buildWorstHeap(popSize);   // Order the population worst first
+
+} // beginSteadyState()
+
+
+void Crossover::breedChildren(int popSize,                           // *In*
+                              Board* offspring[2])                    // *Out*
+{ // Selects two parents from the current population and breeds them in to
+  // scratch boards for steady state mode, setting offspring to point to the
+  // children. The children are fixed and hashed but not yet in the population.
+  // Crowding also matches each child with the parent it competes with
 
-    do
-    { // Loop to make sure both selected parents are not the same candidate
-      selectParents(parents, popSize, totalFitness);
-    } while (parents[0]->boardID == parents[1]->boardID);
+  Board* parents[2];         // Two boards that have been selected as parents
+  Board* rivals[2];          // Parent each child faces when crowding
+
+  children.resize(2);
 
-    reproduce(parents);  // Breed the parents together
-    checkDuplication();  // Check for any duplicate pieces
+  selectParents(parents, popSize);  // Select two different parents
 
-    popCount += 2;       // Increment offspring count by 2
+  for (int i = 0; i < 2; i++)
+  { // Breed in to the scratch boards
+    offspring[i] = &children[i];
   }
 
-  doElitism(); // Transfer the elites over to new generation
+  reproduce(parents, offspring);  // Breed the parents together
+  checkDuplication(offspring);    // Check for any duplicate pieces
 
-} // doCrossover()
+  for (int i = 0; i < 2; i++)
+  { // Hash both children now the duplicate pieces have been fixed
+    boardMan->hashBoard(offspring[i]);
+  }
+
+  if (selectType == CROWDING)
+  { // Match each child with the parent it may replace
+    matchRivals(parents, offspring, rivals);
+
+    for (int i = 0; i < 2; i++)
+    { // Store the population index of each rival
+      childRivals[i] = (int)(rivals[i] - &selectPop->at(0));
+    }
+  }
+
+} // breedChildren()
+
+
+int Crossover::getReplaceIndex(int popSize,                           // *In*
+                               bool isTournament,                     // *In*
+                               int child)                             // *In*
+{ // Returns the index of the board the steady state child given replaces,
+  // either the worst board from the top of the worst heap or the loser of a
+  // tournament. Crowding returns the parent the child was matched with, which
+  // the caller puts back if it is better than the finished child
+
+  int loser = 0;                             // Index of board to replace
+
+  if (selectType == CROWDING)
+  { // The child competes with the parent it is most like
+    loser = childRivals[child];
+  }
+  else if (isTournament)
+  { // Hold a tournament, the board with the lowest fitness loses
+    GeneticAlgorithm::genRandomBatch(0, popSize - 1, tournamentSize,
+                                     &draws[0]);
+    loser = draws[0];
+
+    for (int j = 1; j < tournamentSize; j++)
+    {
+      if (selectFitness[draws[j]] < selectFitness[loser])
+      { // If worse than the current loser, store as loser
+        loser = draws[j];
+      }
+    }
+  }
+  else
+  { // The worst board is always at the top of the worst heap
+    loser = worstHeap[0];
+  }
+
+  return loser;              // Return index of board to replace
+
+} // getReplaceIndex()
+
+
+void Crossover::updateFitness(int index,                              // *In*
+                              int fitScore)                           // *In*
+{ // Stores the fitness of a board that has been replaced by a steady state
+  // child once the child has been scored, moving it within the worst heap
+
+  totalFitness += fitScore - selectFitness[index];  // Keep total up to date
+  selectFitness[index] = fitScore;                  // Store new fitness
+  lowerWorst(raiseWorst(heapPos[index]));           // Reorder the heap
+
+} // updateFitness()
+
+
+void Crossover::buildWorstHeap(int popSize)                           // *In*
+{ // Builds the worst heap over every board of the selection population from
+  // the fitness loaded in to selectFitness
+
+  worstHeap.resize(popSize);
+  heapPos.resize(popSize);
+
+  for (int i = 0; i < popSize; i++)
+  { // Start with the boards in population order
+    worstHeap[i] = i;
+    heapPos[i] = i;
+  }
+
+  for (int i = popSize / 2 - 1; i >= 0; i--)
+  { // Sift each parent down from the last parent to the top
+    lowerWorst(i);
+  }
+
+} // buildWorstHeap()
+
+
+int Crossover::raiseWorst(int position)                               // *In*
+{ // Moves the board at the heap position given up the worst heap while it is
+  // worse than its parent, returning the position it ends up at
+
+  while (position > 0 && selectFitness[worstHeap[position]] <
+                         selectFitness[worstHeap[(position - 1) / 2]])
+  { // While worse than its parent, move up
+    swapWorst(position, (position - 1) / 2);
+    position = (position - 1) / 2;
+  }
+
+  return position;           // Return where the board ended up
+
+} // raiseWorst()
+
+
+void Crossover::lowerWorst(int position)                              // *In*
+{ // Moves the board at the heap position given down the worst heap while a
+  // child is worse than it
+
+  int size = (int)worstHeap.size();  // Boards in the heap
+  int child = 0;                     // Worse child of the position
+
+  while (position * 2 + 1 < size)
+  { // While it has a child, move down if a child is worse
+
+    child = position * 2 + 1;
+
+    if (child + 1 < size && selectFitness[worstHeap[child + 1]] <
+                            selectFitness[worstHeap[child]])
+    { // Use the worse of the two children
+      child++;
+    }
+
+    if (selectFitness[worstHeap[child]] >= selectFitness[worstHeap[position]])
+    { // Heap is in order again
+      break;
+    }
+
+    swapWorst(position, child);
+    position = child;
+  }
+
+} // lowerWorst()
 
 
-void Crossover::selectParents(Board* parents[2],                      // *Out*                
-                              int popSize,                            // *In*
-                              int totalFitness)                       // *In*
-{ // Selects with candidates to use for reproduction with the selection method  
-  // chosen when the application was started
+void Crossover::swapWorst(int position1,                              // *In*
+                          int position2)                              // *In*
+{ // Swaps the boards at the two heap positions given, keeping heapPos in step
 
-  if (selectType == ROULETTE) 
+  std::swap(worstHeap[position1], worstHeap[position2]);
+  heapPos[worstHeap[position1]] = position1;
+  heapPos[worstHeap[position2]] = position2;
+
+} // swapWorst()
+
+
+void Crossover::loadFitness(int popSize)                              // *In*
+{ // Copies the fitness of every board in the selection population in to
+  // selectFitness and totals it for roulette selection
+
+  selectFitness.resize(popSize);
+  totalFitness = 0;
+
+  for (int i = 0; i < popSize; i++)
+  { // Copy the fitness of each board and add it to the total
+    selectFitness[i] = selectPop->at(i).fitScore;
+    totalFitness += selectFitness[i];
+  }
+
+} // loadFitness()
+
+
+void Crossover::selectParents(Board* parents[2],                      // *Out*
+                              int popSize)                            // *In*
+{ // Selects with candidates to use for reproduction with the selection method
+  // chosen when the application was started. The two parents are always
+  // different boards
+
+  if (selectType == ROULETTE)
   { // If roulette method was chosen, do roulette
-    rouletteSelect(parents, totalFitness, popSize);
+    rouletteSelect(parents, popSize);
   }
-  else if (selectType == TOURNAMENT) 
+  else if (selectType == TOURNAMENT)
   { // If tournament method was chosen, do tournament
     tournamentSelect(parents, popSize);
   }
-  else 
+  else if (selectType == CROWDING)
+  { // If crowding was chosen, pick any two boards
+    randomSelect(parents, popSize);
+  }
+  else
   { // Output error, method not recognised
     std::cout << "Selection method not recognised" << std::endl;
   }
@@ -94,48 +391,69 @@ void Crossover::selectParents(Board* parents[2],                      // *Out*
 } // selectParents()
 
 
-void Crossover::rouletteSelect(Board* parents[2],                     // *Out* 
-                               int totalFitness,                      // *In*
+void Crossover::rouletteSelect(Board* parents[2],                     // *Out*
                                int popSize)                           // *In*
-{ // Selects candidates via the roulette wheel method mentioned within the 
-  // report in chapter 3
+{ // Selects candidates via the roulette wheel method mentioned within the
+  // report in chapter 3. The second spin leaves out the first parent
 
-  int oldFitness = 0;     // Holds the older combined fitness score
+  int index[2] = { -1, -1 };     // Index of each parent in the population
 
-  // Index to hold which parent the iteration relates to
-  int boardIndex = (int)BoardManager::getInstance()->getOldPop()->size() - 1;
+  // Spin over every board for the first parent
+  index[0] = spinWheel(popSize, totalFitness, -1);
 
-  // Holds two random indexes to use as indexes in total fitness
-  int randomIndex[2] = { -1, -1 };
-    
-  // Generate two random indexes to use in total fitness
-  GeneticAlgorithm::genRandomNum(0, totalFitness, &randomIndex[0]);
-  GeneticAlgorithm::genRandomNum(0, totalFitness, &randomIndex[1]);
+  // Spin over every board but the first parent for the second parent
+  index[1] = spinWheel(popSize, totalFitness - selectFitness[index[0]],
+                       index[0]);
 
-  totalFitness = 0;   // Set to 0 to accumulate total fitness again
-  
-  for (int i = 0; i < popSize; i++)
-  { // Loops through all boards accumulating the fitness scores, if random 
-    // number is between total fitness and the previous total fitness, set the 
-    // ID of the parent
+  parents[0] = &selectPop->at(index[0]);
+  parents[1] = &selectPop->at(index[1]);
+
+} // rouletteSelect()
 
-    oldFitness = totalFitness;    // Store the total fitness
 
-    // Sum current total fitness and fitness of next candidate
-    totalFitness += BoardManager::getInstance()->getOldPop()->at(i).fitScore;
+int Crossover::spinWheel(int popSize,                                 // *In*
+                         int total,                                   // *In*
+                         int skipIndex)                               // *In*
+{ // Spins the roulette wheel over every board apart from the board with the
+  // index given, returning the index of the board the wheel stops on
 
-    if (totalFitness >= randomIndex[0] && randomIndex[0] >= oldFitness)
-    { // If section has been found for first parent, set ID
-      parents[0] = &BoardManager::getInstance()->getOldPop()->at(i);
+  int randomIndex = -1;          // Random point on the wheel
+  int sum = 0;                   // Fitness accumulated so far
+  int last = -1;                 // Last board that could be chosen
+
+  if (total <= 0)
+  { // If there is no fitness to spin over, choose any board but the skipped
+    GeneticAlgorithm::genRandomNum(0, popSize - (skipIndex >= 0 ? 2 : 1),
+                                   &randomIndex);
+
+    return (skipIndex >= 0 && randomIndex >= skipIndex) ? randomIndex + 1 :
+                                                          randomIndex;
+  }
+
+  // Generate a random point on the wheel
+  GeneticAlgorithm::genRandomNum(0, total - 1, &randomIndex);
+
+  for (int i = 0; i < popSize; i++)
+  { // Loops through all boards accumulating the fitness scores until the
+    // section of the wheel the random point is in has been found
+
+    if (i == skipIndex)
+    { // The skipped board has no section on the wheel
+      continue;
     }
 
-    if (totalFitness >= randomIndex[1] && randomIndex[1] >= oldFitness)
-    { // If section has been found for first parent, set ID
-      parents[1] = &BoardManager::getInstance()->getOldPop()->at(i);
+    sum += selectFitness[i];     // Add fitness of board to the sum
+    last = i;
+
+    if (sum > randomIndex)
+    { // If section has been found, return the index
+      return i;
     }
-  } // for i < getOldPop()
+  } // for i < popSize
 
-} // rouletteSelect()
+  return last;                   // Return the last board if none found
+
+} // spinWheel()
 
 
 void Crossover::tournamentSelect(Board* parents[2],                   // *Out*
@@ -143,52 +461,172 @@ void Crossover::tournamentSelect(Board* parents[2],                   // *Out*
 { // Selects candidates via the tournament selection method mentioned within the
   // report in chapter 3. Does not remove candidate from selection
   // after being selected so candidate can be in tournament multiple times.
+  // The second tournament is drawn from every board but the first parent
 
-  int highfitness = -1;          // Holds the current highest fitness found
-  int boardID = -1;              // Holds random index to compare fitness
+  int best = -1;                 // Index of the best board in the tournament
+  int first = -1;                // Index of the first parent
 
   for (int i = 0; i < 2; i++)
   { // Loop to find both parents
 
-    highfitness = -1;    // Set current highest fitness to -1
-    boardID = -1;        // Set current board ID to -1
+    // Draw every contestant of the tournament at once, the second tournament
+    // draws from one less board so the first parent can be stepped over
+    GeneticAlgorithm::genRandomBatch(0, popSize - 1 - i, tournamentSize,
+                                     &draws[0]);
 
     for (int j = 0; j < tournamentSize; j++)
-    { // Test 20 random candidates storing highest fitness and ID
-
-      // Generate a random boardID then 
-      GeneticAlgorithm::genRandomNum(0, popSize - 1, &boardID);
-
-      if ((BoardManager::getInstance()->getOldPop()->at(boardID).fitScore) > 
-          highfitness)
-      { // Test to see if the fitness score of that candidate is highest than the
-        // current stored fitness
+    { // Step over the first parent by moving every later index up by one
+      if (first >= 0 && draws[j] >= first)
+      {
+        draws[j]++;
+      }
+    }
 
-        // Store board ID
-        parents[i] = &BoardManager::getInstance()->getOldPop()->at(boardID);
+    best = draws[0];             // First contestant is the best so far
 
-        // Store current highest fitness
-        highfitness = parents[i]->fitScore;
+    for (int j = 1; j < tournamentSize; j++)
+    { // Compare the fitness of the contestants by index, storing the best
+      if (selectFitness[draws[j]] > selectFitness[best])
+      {
+        best = draws[j];
       }
-
     } // for j < tournamentSize
 
+    parents[i] = &selectPop->at(best);    // Store the winner as the parent
+    first = best;                         // Second parent skips the winner
+
   } // for i < 2
 
 } // tournamentSelect()
 
 
-void Crossover::reproduce(Board* parents[2])                          // *In*
+void Crossover::randomSelect(Board* parents[2],                       // *Out*
+                             int popSize)                             // *In*
+{ // Selects two different candidates at random, used by crowding when steady
+  // state breeds one pair at a time
+
+  int index[2] = { -1, -1 };     // Index of each parent in the population
+
+  // Draw the second index from one less board then step over the first
+  GeneticAlgorithm::genRandomNum(0, popSize - 1, &index[0]);
+  GeneticAlgorithm::genRandomNum(0, popSize - 2, &index[1]);
+
+  if (index[1] >= index[0])
+  { // Move indexes from the first parent onwards up by one
+    index[1]++;
+  }
+
+  parents[0] = &selectPop->at(index[0]);
+  parents[1] = &selectPop->at(index[1]);
+
+} // randomSelect()
+
+
+void Crossover::shuffleCrowd(int popSize)                             // *In*
+{ // Shuffles the population indexes so crowding can pair every board with
+  // the board next to it in the shuffled order
+
+  int swapIndex = -1;            // Random index to swap with
+
+  crowdOrder.resize(popSize);
+
+  for (int i = 0; i < popSize; i++)
+  { // Start with every index in order
+    crowdOrder[i] = i;
+  }
+
+  for (int i = popSize - 1; i > 0; i--)
+  { // Swap each index with a random index at or before it
+    GeneticAlgorithm::genRandomNum(0, i, &swapIndex);
+    std::swap(crowdOrder[i], crowdOrder[swapIndex]);
+  }
+
+} // shuffleCrowd()
+
+
+void Crossover::matchRivals(Board* parents[2],                        // *In*
+                            Board* offspring[2],                      // *In*
+                            Board* rivals[2])                         // *Out*
+{ // Matches each child with the parent it is most like, so the two pairings
+  // together differ in the fewest slots
+
+  rivals[0] = parents[0];
+  rivals[1] = parents[1];
+
+  if (getDistance(parents[0], offspring[1]) +
+      getDistance(parents[1], offspring[0]) <
+      getDistance(parents[0], offspring[0]) +
+      getDistance(parents[1], offspring[1]))
+  { // If the children are closer to the other parent, swap the rivals
+    rivals[0] = parents[1];
+    rivals[1] = parents[0];
+  }
+
+} // matchRivals()
+
+
+void Crossover::doCrowding()
+{ // Deterministic crowding, run once the offspring have been mutated and
+  // scored. Each offspring is compared with the parent it is most like and
+  // the parent is copied back in if it is better than the finished child
+
+  std::shared_ptr<std::vector<Board>> newPop =
+    boardMan->getPop();                           // New generation
+  int boardID = -1;                               // ID of the offspring slot
+
+  for (int i = 0; i < (int)crowdRivals.size(); i++)
+  { // Keep the parent instead of the child if the parent is better
+
+    Board* rival = &selectPop->at(crowdRivals[i]);
+
+    if (newPop->at(i) < *rival)
+    { // Copy the parent over the child, keeping the ID of the slot
+      boardID = newPop->at(i).boardID;
+      newPop->at(i) = *rival;
+      newPop->at(i).boardID = boardID;
+    }
+  }
+
+  crowdRivals.clear();       // Competition done until the next generation
+
+} // doCrowding()
+
+
+int Crossover::getDistance(Board* board1,                             // *In*
+                           Board* board2)                             // *In*
+{ // Returns how many slots of the two boards hold different pieces
+
+  int distance = 0;              // Count of slots that differ
+
+  for (int i = 0; i < (int)board1->boardVecs.size(); i++)
+  { // Loop through every column of the boards
+
+    for (int j = 0; j < (int)board1->boardVecs[i].size(); j++)
+    { // Count the slot if the pieces are not the same
+      if (board1->boardVecs[i][j].pieceID != board2->boardVecs[i][j].pieceID)
+      {
+        distance++;
+      }
+    }
+  }
+
+  return distance;               // Return the count of slots that differ
+
+} // getDistance()
+
+
+void Crossover::reproduce(Board* parents[2],                          // *In*
+                          Board* offspring[2])                        // *Out*
 { // Calls whichever crossover method that has been selected during the start of
   // the application
 
   if (crossType == ONEPOINT)
   { // If crossover is one point, do one point
-    onePoint(parents);
+    onePoint(parents, offspring);
   }
   else if (crossType == TWOPOINT)
   { // If crossover is two point, do two point
-    twoPoint(parents);
+    twoPoint(parents, offspring);
   }
   else
   { // Output error of crossover not recognised
@@ -204,24 +642,32 @@ void Crossover::copyPieces(int numOfPieces,                           // *In*
                            Board* parent2,                            // *In*
                            Board* offspring1,                         // *Out*
                            Board* offspring2)                         // *Out*
-{ // Adds multiple pieces from the parent to appropriate offspring (parent1 
+{ // Copies multiple pieces from the parent to appropriate offspring (parent1 
   // into offpsing1, parent2 into offspring2). Number of pieces is passed in
-  // as a parameter
+  // as a parameter, counting only slots that are not locked
 
-  for (int i = 0; i < numOfPieces; i++)
+  int copied = 0;       // How many free slots have been copied
+
+  while (copied < numOfPieces)
   { // Copy pieces from the parent to the corrosponding offspring
 
-    // Copy piece from parent1 into offspring1
-    offspring1->boardVecs[index[0]].push_back(parent1->
-                                              boardVecs[index[0]][index[1]]);
+    if (!boardMan->isLocked(index[0], index[1]))
+    { // Locked slots already hold their piece, only copy free slots
+
+      // Copy piece from parent1 into offspring1
+      offspring1->boardVecs[index[0]][index[1]] = parent1->
+                                                  boardVecs[index[0]][index[1]];
+
+      // Copy piece from parent2 into offspring2
+      offspring2->boardVecs[index[0]][index[1]] = parent2->
+                                                  boardVecs[index[0]][index[1]];
 
-    // Copy piece from parent2 into offspring2
-    offspring2->boardVecs[index[0]].push_back(parent2->
-                                              boardVecs[index[0]][index[1]]);
+      copied++;  // Count the copied slot
+    }
 
     index[0]++;  // Increment the xIndex to move to next slot in row
 
-    if (index[0] == BoardManager::getInstance()->getSize() + 1)
+    if (index[0] == boardMan->getSize() + 1)
     { // If we have reached the end of the line of the board, increment row
       index[0] = 0;
       index[1]++;
@@ -231,65 +677,55 @@ void Crossover::copyPieces(int numOfPieces,                           // *In*
 } // copyPiece()
 
 
-void Crossover::onePoint(Board* parents[2])                           // *In*
+void Crossover::onePoint(Board* parents[2],                           // *In*
+                         Board* offspring[2])                         // *Out*
 { // Takes two candidates, selects a point of the candidate to slice and 
   // exchanges the data after that point with the second parent, explained 
   // fully in the report, chapter 3
 
-  Board offspring[2];         // Holds the two new offspring boards
   int index[2] = { 0, 0 };    // Index of the current piece to copy over
 
-  // Work out number of pieces to avoid calculations for each check below.
-  // + 1 to include the 0 index
-  int numOfPieces = (BoardManager::getInstance()->getSize() + 1) *
-                    (BoardManager::getInstance()->getSize() + 1);
+  // Work out number of free slots to avoid calculations for each check below.
+  // + 1 to include the 0 index, locked slots are never cut or copied
+  int numOfPieces = (boardMan->getSize() + 1) * (boardMan->getSize() + 1) -
+                    (int)boardMan->getLocks()->size();
 
   int crossPoint = -1;     // Holds the crossover point
 
   // Get random crossover point to split the boards
   GeneticAlgorithm::genRandomNum(1, numOfPieces - 1, &crossPoint);
 
-  // Initialise new empty boards for both offspring
-  BoardManager::getInstance()->initEmptyBoard(&offspring[0]);
-  BoardManager::getInstance()->initEmptyBoard(&offspring[1]);
+  // Make sure both offspring have a slot for every piece, reusing storage,
+  // with the locked pieces already in place
+  boardMan->shapeBoard(offspring[0]);
+  boardMan->shapeBoard(offspring[1]);
 
   // Copy pieces from parent1 to offspring1 and parent2 to offspring2 until
   // the crossover point has been reached
-  copyPieces(crossPoint, index, parents[0], parents[1], &offspring[0], 
-              &offspring[1]);
+  copyPieces(crossPoint, index, parents[0], parents[1], offspring[0], 
+              offspring[1]);
 
   // Copy pieces from parent1 to offspring2 and parent2 to offspring1 until
   // the end of the board
   copyPieces((numOfPieces - crossPoint), index, parents[0], parents[1], 
-              &offspring[1], &offspring[0]);
-  
-  for (int i = 0; i < 2; i++)
-  { // Set boardID and push the new offspring on to the new population
-
-    // Set boardID
-    offspring[i].boardID = (int)BoardManager::getInstance()->getPop()->
-      size() + 1;
-
-    // Push on to board vector
-    BoardManager::getInstance()->getPop()->push_back(offspring[i]);
-  }
+              offspring[1], offspring[0]);
 
 } // onePoint()
 
 
-void Crossover::twoPoint(Board* parents[2])                           // *In*
+void Crossover::twoPoint(Board* parents[2],                           // *In*
+                         Board* offspring[2])                         // *Out*
 { // Takes two candidates, selects two points of the candidate to slice and
   // exchanges the data after that point with the second parent, switching
   // again after the second point. Explained fully in the report, chapter 3.
 
-  Board offspring[2];             // Holds the two new offspring boards
   int index[2] = { 0, 0 };        // xIndex of the current piece to copy over
   int crossPoint[2] = { -1, -1 }; // Holds the two crossover points
 
-  // Work out number of pieces to avoid calculations for each check below.
-  // + 1 to include the 0 index
-  int numOfPieces = (BoardManager::getInstance()->getSize() + 1) *
-                    (BoardManager::getInstance()->getSize() + 1);
+  // Work out number of free slots to avoid calculations for each check below.
+  // + 1 to include the 0 index, locked slots are never cut or copied
+  int numOfPieces = (boardMan->getSize() + 1) * (boardMan->getSize() + 1) -
+                    (int)boardMan->getLocks()->size();
 
   // Get two random crossover points to split the boards, making sure the second
   // generated number is after the first
@@ -297,59 +733,40 @@ void Crossover::twoPoint(Board* parents[2])                           // *In*
   GeneticAlgorithm::genRandomNum(crossPoint[0] + 1, numOfPieces, 
                                  &crossPoint[1]);
 
-  // Initialise new empty boards and give the boards an ID
-  BoardManager::getInstance()->initEmptyBoard(&offspring[0]);
-  BoardManager::getInstance()->initEmptyBoard(&offspring[1]);
+  // Make sure both offspring have a slot for every piece, reusing storage,
+  // with the locked pieces already in place
+  boardMan->shapeBoard(offspring[0]);
+  boardMan->shapeBoard(offspring[1]);
 
   // Copy pieces from parent1 to offspring1 and parent2 to offspring2 until
   // the crossover point has been reached
-  copyPieces(crossPoint[0], index, parents[0], parents[1], &offspring[0],
-             &offspring[1]);
+  copyPieces(crossPoint[0], index, parents[0], parents[1], offspring[0],
+             offspring[1]);
 
   // Copy pieces from parent1 to offspring2 and parent2 to offspring1 until
   // the end of the board
   copyPieces((crossPoint[1] - crossPoint[0]), index, parents[0], parents[1],
-             &offspring[1], &offspring[0]);
+             offspring[1], offspring[0]);
 
   // Copy pieces from parent1 to offspring1 and parent2 to offspring2 until
   // the crossover point has been reached
   copyPieces((numOfPieces - crossPoint[1]), index, parents[0], parents[1], 
-             &offspring[0], &offspring[1]);
-
-  for (int i = 0; i < 2; i++)
-  { // Set boardID and push the new offspring on to the new population
-
-    // Set boardID
-    offspring[i].boardID = (int)BoardManager::getInstance()->getPop()->
-      size() + 1;
-
-    // Push on to board vector
-    BoardManager::getInstance()->getPop()->push_back(offspring[i]);
-  }
+             offspring[0], offspring[1]);
 
 } // twoPoint()
 
 
-void Crossover::checkDuplication()
+void Crossover::checkDuplication(Board* offspring[2])                 // *In-Out*
 { // Scans through candidate to check if puzzle pieces end up appearing twice
   // within the same candidate, taking the duplicate list from one candidate
   // to place pieces within the candidate that no longer has them
 
-  // Holds location of both offspring
-  Board* offspring[2];   
-
   // Holds list of duplicate pieces found
-  std::vector<PuzzlePiece> pieces[2];  
+  std::vector<PackedPiece> pieces[2];  
 
   // Holds the indexes of duplicate pieces
   std::vector<std::vector<int>> indexes[2];
 
-  // Get the addresses of the last two boards created
-  offspring[0] = &BoardManager::getInstance()->getPop()->at(
-                    BoardManager::getInstance()->getPop()->size() - 2);
-  offspring[1] = &BoardManager::getInstance()->getPop()->at(
-                    BoardManager::getInstance()->getPop()->size() - 1);
-
   for (int i = 0; i < 2; i++)
   { // Call to find out which pieces are duplicates, storing in the pieces
   // and index vectors ready for fixing
@@ -367,20 +784,16 @@ void Crossover::checkDuplication()
 
 
 void Crossover::getDuplicates(Board* theBoard,                        // *In* 
-                              std::vector<PuzzlePiece>* pieces,       // *Out*
+                              std::vector<PackedPiece>* pieces,       // *Out*
                               std::vector<std::vector<int>>* indexes) // *Out*
 {
   // Store the boardSize for easier code readability and quicker access
-  int boardSize = BoardManager::getInstance()->getSize();
+  int boardSize = boardMan->getSize();
 
   // Vector to check IDs against
-  std::vector<bool> isFound((*BoardManager::getInstance()->getPieces())[CORNER].
-                            size() +
-                             (*BoardManager::getInstance()->getPieces())[EDGE].
-                            size() +
-                             (*BoardManager::getInstance()->getPieces())[INNER].
-                            size(), 
-                             false);
+  std::vector<bool> isFound((*boardMan->getPieces())[CORNER].size() +
+                            (*boardMan->getPieces())[EDGE].size() +
+                            (*boardMan->getPieces())[INNER].size(), false);
 
   // Check the corner slots for duplicates
   checkCorners(theBoard, pieces, indexes, boardSize, &isFound);
@@ -395,7 +808,7 @@ void Crossover::getDuplicates(Board* theBoard,                        // *In*
 
 
 void Crossover::checkCorners(Board* theBoard,                         // *In*
-                             std::vector<PuzzlePiece>* pieces,        // *Out*
+                             std::vector<PackedPiece>* pieces,        // *Out*
                              std::vector<std::vector<int>>* indexes,  // *Out*
                              int boardSize,                           // *In*
                              std::vector<bool>* isFound)              // *In*
@@ -445,7 +858,7 @@ void Crossover::checkCorners(Board* theBoard,                         // *In*
 
 
 void Crossover::checkEdges(Board* theBoard,                          // *In*
-                           std::vector<PuzzlePiece>* pieces,         // *Out*
+                           std::vector<PackedPiece>* pieces,         // *Out*
                            std::vector<std::vector<int>>* indexes,   // *Out*
                            int boardSize,                            // *In*
                            std::vector<bool>* isFound)               // *In-Out*
@@ -506,7 +919,7 @@ void Crossover::checkEdges(Board* theBoard,                          // *In*
 
 
 void Crossover::checkInners(Board* theBoard,                         // *In*
-                            std::vector<PuzzlePiece>* pieces,        // *Out*
+                            std::vector<PackedPiece>* pieces,        // *Out*
                             std::vector<std::vector<int>>* indexes,  // *Out*
                             int boardSize,                           // *In*
                             std::vector<bool>* isFound)              // *In-Out*
@@ -516,8 +929,7 @@ void Crossover::checkInners(Board* theBoard,                         // *In*
   int yIndex = 1;  // Y index for slot
   int xIndex = 1;  // X index for slot
 
-  for (int i = 0; i < (int)(*BoardManager::getInstance()->getPieces())[INNER].
-       size(); i++)
+  for (int i = 0; i < (int)(*boardMan->getPieces())[INNER].size(); i++)
   { // Loop through for every inner slot changing the appropriate element
     // to true if piece was found
 
@@ -534,7 +946,7 @@ void Crossover::checkInners(Board* theBoard,                         // *In*
 
     xIndex++;    // Increment X index to move to the slot on the right
 
-    if (xIndex == BoardManager::getInstance()->getSize())
+    if (xIndex == boardMan->getSize())
     { // If we have reached the end of the line of the board, increment
       // to next line
       xIndex = 1;   // Set x back to 1
@@ -546,49 +958,95 @@ void Crossover::checkInners(Board* theBoard,                         // *In*
 
 
 void Crossover::fixDuplicates(Board* theBoard,                       // *In-Out*
-                              std::vector<PuzzlePiece> pieces,       // *In*
+                              std::vector<PackedPiece> pieces,       // *In*
                               std::vector<std::vector<int>> indexes) // *In*   
 { // Uses the vector of pieces along with the vector of slot indexes to place
   // pieces that are needed to to have every unique puzzle piece with in the
   // candidate
 
+  PieceType pieceType = DEFAULT;  // Type of the piece being placed
+
   for (int i = 0; i < (int)pieces.size(); i++)
   { // Loop right placing the next piece that needs to be placed within the
     // board to the next slot with a duplicate piece and call to fix orientation
     theBoard->boardVecs[indexes[i][0]][indexes[i][1]] = pieces[i];
+    pieceType = boardMan->getPiece(pieces[i].pieceID)->type;
     
-    if (theBoard->boardVecs[indexes[i][0]][indexes[i][1]].type == CORNER ||
-        theBoard->boardVecs[indexes[i][0]][indexes[i][1]].type == EDGE)
+    if (pieceType == CORNER || pieceType == EDGE)
     { // If piece is an edge or corner piece, make sure piece is properly 
       // rotated
-      BoardManager::getInstance()->fixOrien(&theBoard->boardVecs[indexes[i][0]]
-                                            [indexes[i][1]], indexes[i][0],
-                                            indexes[i][1]);
+      boardMan->fixOrien(&theBoard->boardVecs[indexes[i][0]][indexes[i][1]],
+                         indexes[i][0], indexes[i][1]);
     }
   }
 
 } // fixDuplicates()
 
 
-void Crossover::doElitism()
-{ // Adds the best and worst candidtes from the previous generation to the new
-  // generation. The amount of candidates is declared in eliteRate
+bool Crossover::isDuplicatePair(Board* offspring[2],                 // *In-Out*
+                                unsigned long long canonHashes[2])    // *Out*
+{ // Hashes the two offspring, then returns whether either is a copy or a
+  // turned copy of a board already in the new population. The canonical
+  // hashes are given back so the pair does not have to be hashed again
 
-  // Sort the vector in ascending order to for easy access to elites
-  std::sort(BoardManager::getInstance()->getOldPop()->begin(),
-            BoardManager::getInstance()->getOldPop()->end());
+  for (int i = 0; i < 2; i++)
+  { // Hash both offspring now the duplicate pieces have been fixed
+    boardMan->hashBoard(offspring[i]);
+    canonHashes[i] = boardMan->getCanonicalHash(offspring[i]);
+  }
+
+  // Copies of each other or of an earlier offspring are duplicates
+  return canonHashes[0] == canonHashes[1] ||
+         popHashes.count(canonHashes[0]) > 0 ||
+         popHashes.count(canonHashes[1]) > 0;
+
+} // isDuplicatePair()
+
+
+void Crossover::doElitism(int firstIndex)                             // *In*
+{ // Copies the best and worst candidtes from the previous generation in to the
+  // new generation from the index given. The amount of candidates is declared
+  // in eliteRate. Selects the elites from keys instead of sorting the boards
+
+  std::shared_ptr<std::vector<Board>> oldPop =
+    boardMan->getOldPop();                        // Previous generation
+  std::shared_ptr<std::vector<Board>> newPop =
+    boardMan->getPop();                           // New generation
+  int count = (int)oldPop->size();                // Boards in old generation
+
+  eliteKeys.resize(count);
+
+  for (int i = 0; i < count; i++)
+  { // Make a key for each board so the boards themselves are never moved
+    eliteKeys[i].fitScore = oldPop->at(i).fitScore;
+    eliteKeys[i].matchCount = oldPop->at(i).matchCount;
+    eliteKeys[i].index = i;
+  }
+
+  if (count < (eliteRate * 2) + 1)
+  { // If the best and worst overlap, put every key in order
+    std::sort(eliteKeys.begin(), eliteKeys.end());
+  }
+  else
+  { // Otherwise only move the best eliteRate keys to the end and the worst
+    // eliteRate + 1 keys to the start, with the very worst first
+    std::nth_element(eliteKeys.begin(), eliteKeys.end() - eliteRate,
+                     eliteKeys.end());
+    std::nth_element(eliteKeys.begin(), eliteKeys.begin() + eliteRate,
+                     eliteKeys.end() - eliteRate);
+    std::nth_element(eliteKeys.begin(), eliteKeys.begin(),
+                     eliteKeys.begin() + eliteRate + 1);
+  }
 
   for (int i = 1; i < eliteRate + 1; i++)
-  { // Take the best and the worst candidates from the previous generation
-    // and push to the new generation vector
+  { // Take the best and the worst candidates from the previous generation,
+    // skipping the very worst, and copy in to the new generation by index
 
-    // Push worst on to new population
-    BoardManager::getInstance()->getPop()->push_back(BoardManager::getInstance()
-                                                     ->getOldPop()->begin()[i]);
+    // Copy worst in to new population
+    newPop->at(firstIndex++) = oldPop->at(eliteKeys.begin()[i].index);
 
-    // Push best on to new population
-    BoardManager::getInstance()->getPop()->push_back(BoardManager::getInstance()
-                                                     ->getOldPop()->end()[-i]);
+    // Copy best in to new population
+    newPop->at(firstIndex++) = oldPop->at(eliteKeys.end()[-i].index);
   }
 
 } // doElitism()
\ No newline at end of file
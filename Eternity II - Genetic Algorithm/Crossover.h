@@ -7,17 +7,39 @@
 #pragma once                    // Only include once
 
 
+#include "BoardManager.h"       // Pieces and board definition
 #include <vector>               // Ability to create vector
+#include <memory>               // Shared pointer to population
+#include <unordered_set>        // Hashes of offspring already created
+
+
+#define DEDUPRETRIES 3          // Times a duplicate pair of offspring is
+                                // bred again before it is accepted
 
 
 // Readability for methods of crossover
 enum CrossoverType { ONEPOINT, TWOPOINT, CROSSDEFAULT };
 
 // Readability for methods of selection
-enum SelectionType { ROULETTE, TOURNAMENT, SELECTDEFAULT};
+enum SelectionType { ROULETTE, TOURNAMENT, CROWDING, SELECTDEFAULT};
+
+
+struct EliteKey
+{ // Holds what is needed to rank a board without moving the board itself
+
+  int fitScore;       // Fitness score of the board
+  int matchCount;     // Pattern matches in the board
+  int index;          // Index of the board in the population
+
+  // Overrides the less than operator to rank the same way as boards
+  bool operator < (const EliteKey& theKey) const
+  {
+    return fitScore < theKey.fitScore || (fitScore == theKey.fitScore &&
+                                          matchCount < theKey.matchCount);
+  } // bool operator <
+
+}; // EliteKey
 
-struct Board;              // Usage of board types
-struct PuzzlePiece;        // Usage of puzzle piece types
 
 class Crossover
 {
@@ -27,32 +49,121 @@ private:
   SelectionType selectType;             // Holds method of candidate selection
   int tournamentSize;                   // Holds how large tournaments are
   int eliteRate;                        // Holds how many candidates to keep
+  int rejectCount;                      // Duplicate offspring rejected in gen
+  int retries;                          // Times current pair has been rebred
+  int totalFitness;                     // Combined fitness of selectFitness
+  BoardManager* boardMan;               // Board manager of the solver
+
+  // Fitness of every board in the selection population held contiguously, so
+  // selection compares indexes in to this instead of reading the boards
+  std::vector<int> selectFitness;
+
+  // Random indexes drawn in one batch for each tournament
+  std::vector<int> draws;
+
+  // Population indexes kept as a binary min heap on selectFitness, so steady
+  // state finds the worst board at the top instead of scanning the population
+  std::vector<int> worstHeap;
+
+  // Position of each population index within worstHeap
+  std::vector<int> heapPos;
+
+  // Shuffled population indexes, crowding pairs neighbouring indexes
+  std::vector<int> crowdOrder;
+
+  // Index in the previous generation of the parent each offspring competes
+  // with when crowding, empty once the competition has been run
+  std::vector<int> crowdRivals;
+
+  // Canonical hashes of the offspring in the new population, so a turned
+  // copy of an offspring counts as the same board
+  std::unordered_set<unsigned long long> popHashes;
+
+  // Ranking keys of the previous population, used to find the elites
+  std::vector<EliteKey> eliteKeys;
+
+  // Population parents are selected from, the previous generation when
+  // generational and the current population when steady state
+  std::shared_ptr<std::vector<Board>> selectPop;
+
+  // Boards steady state breeds in to before they replace population boards
+  std::vector<Board> children;
+
+  // Population index of the parent each steady state child faces when
+  // crowding, the parent it competes with for its slot
+  int childRivals[2];
+
+  // Copies the fitness of every board in the selection population in to
+  // selectFitness and totals it for roulette selection
+  void loadFitness(int popSize);                                // *In*
+
+  // Builds the worst heap over every board of the selection population from
+  // the fitness loaded in to selectFitness
+  void buildWorstHeap(int popSize);                             // *In*
+
+  // Moves the board at the heap position given up the worst heap while it
+  // is worse than its parent, returning the position it ends up at
+  int raiseWorst(int position);                                 // *In*
+
+  // Moves the board at the heap position given down the worst heap while a
+  // child is worse than it
+  void lowerWorst(int position);                                // *In*
+
+  // Swaps the boards at the two heap positions given, keeping heapPos in step
+  void swapWorst(int position1,                                 // *In*
+                 int position2);                                // *In*
 
   // Selects with candidates to use for reproduction with the selection method  
-  // chosen when the application was started
+  // chosen when the application was started. The two parents are always
+  // different boards
   void selectParents(Board* parents[2],                         // *Out*
-                     int popSize,                               // *In*
-                     int totalFitness);                         // *In*
+                     int popSize);                              // *In*
 
   // Selects candidates via the roulette wheel method mentioned within the 
-  // report in chapter 3
-  void rouletteSelect(Board* parents[2],                       // *Out* 
-                      int totalFitness,                         // *In*
-                      int popSize);                             // *In*                            // *In*
+  // report in chapter 3. The second spin leaves out the first parent
+  void rouletteSelect(Board* parents[2],                        // *Out* 
+                      int popSize);                             // *In*
+
+  // Spins the roulette wheel over every board apart from the board with the
+  // index given, returning the index of the board the wheel stops on
+  int spinWheel(int popSize,                                    // *In*
+                int total,                                      // *In*
+                int skipIndex);                                 // *In*
 
   // Selects candidates via the tournament selection method mentioned within the
   // report in chapter 3. Does not remove candidate from selection
   // after being selected so candidate can be in tournament multiple times.
+  // The second tournament is drawn from every board but the first parent
   void tournamentSelect(Board* parents[2],                      // *Out*
                         int popSize);                           // *In*
 
+  // Selects two different candidates at random, used by crowding when steady
+  // state breeds one pair at a time
+  void randomSelect(Board* parents[2],                          // *Out*
+                    int popSize);                               // *In*
+
+  // Shuffles the population indexes so crowding can pair every board with
+  // the board next to it in the shuffled order
+  void shuffleCrowd(int popSize);                               // *In*
+
+  // Matches each child with the parent it is most like, so the two pairings
+  // together differ in the fewest slots
+  void matchRivals(Board* parents[2],                           // *In*
+                   Board* offspring[2],                         // *In*
+                   Board* rivals[2]);                           // *Out*
+
+  // Returns how many slots of the two boards hold different pieces
+  int getDistance(Board* board1,                                // *In*
+                  Board* board2);                               // *In*
+
   // Calls whichever crossover method that has been selected during the start of
   // the application
-  void reproduce(Board* parents[2]);                            // *In*
+  void reproduce(Board* parents[2],                             // *In*
+                 Board* offspring[2]);                          // *Out*
 
-  // Adds multiple pieces from the parent to appropriate offspring (parent1 
+  // Copies multiple pieces from the parent to appropriate offspring (parent1 
   // into offpsing1, parent2 into offspring2). Number of pieces is passed in
-  // as a parameter
+  // as a parameter, counting only slots that are not locked
   void copyPieces(int numOfPieces,                              // *In*
                   int index[2],                                 // *In*
                   Board* parent1,                               // *In*
@@ -63,29 +174,31 @@ private:
   // Takes two candidates, selects a point of the candidate to slice and 
   // exchanges the data after that point with the second parent, explained fully
   // in the report, chapter 3
-  void onePoint(Board* parents[2]);                             // *In*
+  void onePoint(Board* parents[2],                              // *In*
+                Board* offspring[2]);                           // *Out*
 
   // Takes two candidates, selects two points of the candidate to slice and
   // exchanges the data after that point with the second parent, switching
   // again after the second point. Explained fully in the report, chapter 3.
-  void twoPoint(Board* parents[2]);                             // *In*
+  void twoPoint(Board* parents[2],                              // *In*
+                Board* offspring[2]);                           // *Out*
 
   // Scans through candidate to check if puzzle pieces end up appearing twice
   // within the same candidate, taking the duplicate list from one candidate
   // to place pieces within the candidate that no longer has them
-  void checkDuplication();
+  void checkDuplication(Board* offspring[2]);                   // *In-Out*
 
   // Scans through the candidate board to see if there are any pieces that 
   // appear more than once within the candidate, uses vector to store puzzle 
   // pieces
   void getDuplicates(Board* theBoard,                           // *In*
-                     std::vector<PuzzlePiece>* pieces,          // *Out*
+                     std::vector<PackedPiece>* pieces,          // *Out*
                      std::vector<std::vector<int>>* indexes);   // *Out*
 
   // Checks all corners to see if there are any duplicate pieces within the
   // corner slots, if so store the piece and the index of the duplicate slot
   void checkCorners(Board* theBoard,                            // *In*
-                    std::vector<PuzzlePiece>* pieces,           // *Out*
+                    std::vector<PackedPiece>* pieces,           // *Out*
                     std::vector<std::vector<int>>* indexes,     // *Out*
                     int boardSize,                              // *In*
                     std::vector<bool>* checkIDs);               // *In-Out*
@@ -93,7 +206,7 @@ private:
   // Checks all edges to see if there are any duplicate pieces within the
   // edge slots, if so store the piece and the index of the duplicate slot
   void checkEdges(Board* theBoard,                              // *In*
-                  std::vector<PuzzlePiece>* pieces,             // *Out*
+                  std::vector<PackedPiece>* pieces,             // *Out*
                   std::vector<std::vector<int>>* indexes,       // *Out*
                   int boardSize,                                // *In*
                   std::vector<bool>* checkIDs);                 // *In-Out*
@@ -101,7 +214,7 @@ private:
   // Checks all inner slots to see if there are any duplicate pieces within the
   // inner slots, if so store the piece and the index of the duplicate slot
   void checkInners(Board* theBoard,                             // *In*
-                   std::vector<PuzzlePiece>* pieces,            // *Out*
+                   std::vector<PackedPiece>* pieces,            // *Out*
                    std::vector<std::vector<int>>* indexes,      // *Out*
                    int boardSize,                               // *In*
                    std::vector<bool>* checkIDs);                // *In-Out*
@@ -110,25 +223,87 @@ private:
   // pieces that are needed to to have every unique puzzle piece with in the
   // candidate
   void fixDuplicates(Board* theBoard,                           // *In-Out*
-                     std::vector<PuzzlePiece> pieces,           // *In*
+                     std::vector<PackedPiece> pieces,           // *In*
                      std::vector<std::vector<int>> indexes);    // *In*
 
-  // Adds the best and worst candidtes from the previous generation to the new
-  // generation. The amount of candidates is declared in eliteRate
-  void doElitism();
+  // Hashes the two offspring, then returns whether either is a copy or a
+  // turned copy of a board already in the new population. The canonical
+  // hashes are given back so the pair does not have to be hashed again
+  bool isDuplicatePair(Board* offspring[2],                     // *In-Out*
+                       unsigned long long canonHashes[2]);      // *Out*
 
 public:
-  // Sets tournament size, initalise methods to default
-  Crossover();
+  // Sets tournament size, initalise methods to default and stores the board
+  // manager of the solver
+  Crossover(BoardManager* manager);                             // *In*
 
   // Sets the crossover and selection type to use for crossover along with
-  // the elitism rate
+  // the elitism rate and tournament size
   void setMethod(CrossoverType cross,                           // *In*
                  SelectionType select,                          // *In*
-                 int elite);                                    // *In*
+                 int elite,                                     // *In*
+                 int tournament);                               // *In*
 
   // Selects the parent candidates then commences with crossover with chosen
   // methods
   void doCrossover(int popSize);                                // *In*
 
+  // Gets ready to breed a new generation from the previous one, sizing the
+  // new population. Returns how many offspring are bred before the elites
+  int beginGeneration(int popSize);                             // *In*
+
+  // Breeds the next pair of the generation in to the two slots of the new
+  // population from the index given, setting offspring to point to them.
+  // Returns false if the pair was a copy and has to be bred again
+  bool breedPair(int popSize,                                   // *In*
+                 int popCount,                                  // *In*
+                 Board* offspring[2]);                          // *Out*
+
+  // Copies the best and worst candidtes from the previous generation in to the
+  // new generation from the index given. The amount of candidates is declared
+  // in eliteRate. Selects the elites from keys instead of sorting the boards
+  void doElitism(int firstIndex);                               // *In*
+
+  // Deterministic crowding, run once the offspring have been mutated and
+  // scored. Each offspring is compared with the parent it is most like and
+  // the parent is copied back in if it is better than the finished child
+  void doCrowding();
+
+  // Selects parents from the current population from now on for steady
+  // state mode, loading the fitness of the population for selection and
+  // building the worst heap for replacement
+  void beginSteadyState(int popSize);                           // *In*
+
+  // Selects two parents from the current population and breeds them in to
+  // scratch boards for steady state mode, setting offspring to point to the
+  // children. The children are fixed and hashed but not yet in the population.
+  // Crowding also matches each child with the parent it competes with
+  void breedChildren(int popSize,                               // *In*
+                     Board* offspring[2]);                      // *Out*
+
+  // Returns the index of the board the steady state child given replaces,
+  // either the worst board from the top of the worst heap or the loser of a
+  // tournament. Crowding returns the parent the child was matched with, which
+  // the caller puts back if it is better than the finished child
+  int getReplaceIndex(int popSize,                              // *In*
+                      bool isTournament,                        // *In*
+                      int child);                               // *In*
+
+  // Stores the fitness of a board that has been replaced by a steady state
+  // child once the child has been scored, moving it within the worst heap
+  void updateFitness(int index,                                 // *In*
+                     int fitScore);                             // *In*
+
+  // Returns how many of the best and worst candidates are kept each generation
+  inline int getEliteRate()
+  {
+    return eliteRate;     // Return the elitism rate
+  } // getEliteRate()
+
+  // Returns how many duplicate offspring were rejected last generation
+  inline int getRejectCount()
+  {
+    return rejectCount;   // Return count of rejected offspring
+  } // getRejectCount()
+
 }; // Crossover
\ No newline at end of file
@@ -0,0 +1,232 @@
+// Title        : EDASolver.cpp
+// Purpose      : Samples boards from a model learnt from the best boards
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#include "EDASolver.h"          // Class declaration
+#include <algorithm>            // nth_element(), shuffle()
+#include <numeric>              // iota()
+
+
+EDASolver::EDASolver(BoardManager* manager)                 // *In*
+  : ModelSolver(manager)
+{ // Stores the board manager of the solver and makes a worker for each
+  // hardware thread
+
+  workers.resize(workerCount);      // One worker per hardware thread
+
+} // EDASolver()
+
+
+void EDASolver::reset()
+{ // Sets every choice of the model to the same chance and seeds the workers.
+  // Called once the locks are built and whenever the population restarts
+
+  int rows = 0;                     // Free slots of the type
+  int cols = 0;                     // Piece columns times rotations
+
+  model.assign(3, std::vector<float>());
+  counts.assign(3, std::vector<float>());
+  columnPieces.assign(3, std::vector<int>());
+  pieceColumns.assign((*boardMan->getPieces())[CORNER].size() +
+                      (*boardMan->getPieces())[EDGE].size() +
+                      (*boardMan->getPieces())[INNER].size() + 1, -1);
+
+  for (int type = CORNER; type <= INNER; type++)
+  { // Give each free piece of the type a column, then spread the chance of
+    // every row evenly over the columns
+
+    for (const PuzzlePiece& piece : (*boardMan->getPieces())[type])
+    {
+      if (!boardMan->isPieceLocked(piece.pieceID))
+      {
+        pieceColumns[piece.pieceID] = (int)columnPieces[type].size();
+        columnPieces[type].push_back(piece.pieceID);
+      }
+    }
+
+    rows = (int)boardMan->getFreeSlots(type)->size();
+    cols = (int)columnPieces[type].size() * getRotations(type);
+
+    if (cols > 0)
+    { // Types with every piece locked have nothing to learn
+      model[type].assign(rows * cols, 1.0f / cols);
+      counts[type].assign(rows * cols, 0.0f);
+    }
+  }
+
+  for (EDAWorker& worker : workers)
+  { // Seed each worker
+    worker.generator.seed(nextSeed());
+  }
+
+} // reset()
+
+
+void EDASolver::doGeneration(int popSize,                   // *In*
+                             int eliteRate)                 // *In*
+{ // Learns from the scored population then replaces it with boards sampled
+  // from the model, keeping the best eliteRate boards as they are
+
+  learn(popSize);                   // Update the model from the population
+
+  // Sample the new boards, each worker filling its own share of them
+  nextPopulation(popSize, eliteRate,
+                 [this](Board* theBoard, int worker)
+                 { sampleBoard(theBoard, &workers[worker]); });
+
+} // doGeneration()
+
+
+void EDASolver::learn(int popSize)                          // *In*
+{ // Learns from the best EDATOP of the scored population, blending how often
+  // each piece and rotation was seen in each slot in to the model
+
+  std::shared_ptr<std::vector<Board>> thePop =
+    boardMan->getPop();                       // Scored population
+  int topCount = std::max(1, (int)(popSize * EDATOP));  // Boards learnt from
+  int rotations = 1;                          // Rotations of the type
+  int cols = 0;                               // Piece columns times rotations
+  int index[2] = { -1, -1 };                  // Slot index of a free slot
+  float share = EDARATE / topCount;           // Weight of each board seen
+
+  rankPopulation(popSize);          // Rank the boards without moving them
+
+  // Move the keys of the best boards to the end
+  std::nth_element(keys.begin(), keys.end() - topCount, keys.end());
+
+  for (int type = CORNER; type <= INNER; type++)
+  { // Count and blend each piece type on its own
+
+    std::vector<int>* slots = boardMan->getFreeSlots(type);
+
+    if (model[type].empty())
+    { // Nothing to learn for a type with every piece locked
+      continue;
+    }
+
+    rotations = getRotations(type);
+    cols = (int)columnPieces[type].size() * rotations;
+
+    std::fill(counts[type].begin(), counts[type].end(), 0.0f);
+
+    for (int k = popSize - topCount; k < popSize; k++)
+    { // Count the piece and rotation in each free slot of the best boards
+
+      Board* theBoard = &thePop->at(keys[k].index);
+
+      for (int row = 0; row < (int)slots->size(); row++)
+      {
+        boardMan->getSlotIndex((*slots)[row], index);
+
+        const PackedPiece& slot = theBoard->boardVecs[index[0]][index[1]];
+
+        counts[type][row * cols +
+                     pieceColumns[slot.pieceID] * rotations +
+                     ((rotations > 1) ? slot.orientation : 0)] += 1.0f;
+      }
+    }
+
+    float* chances = model[type].data();      // Model of the type
+    const float* seen = counts[type].data();  // Counts of the type
+
+    for (int i = 0; i < (int)model[type].size(); i++)
+    { // Blend the counts in, each row still adds up to one. A plain loop
+      // over the whole matrix so the compiler can vectorise it
+      chances[i] = (1.0f - EDARATE) * chances[i] + share * seen[i];
+    }
+  }
+
+} // learn()
+
+
+void EDASolver::sampleBoard(Board* theBoard,                // *In-Out*
+                            EDAWorker* worker)              // *In-Out*
+{ // Fills every free slot of the board with a piece and rotation drawn from
+  // the model. Each piece is used once, slots are filled in a random order
+  // so no slot always gets the first choice
+
+  int rotations = 1;                // Rotations of the type
+  int cols = 0;                     // Piece columns times rotations
+  int choice = -1;                  // Column drawn for the slot
+  int index[2] = { -1, -1 };        // Slot index of the free slot
+  float total = 0.0f;               // Total weight of the columns
+  float spin = 0.0f;                // Random point along the weights
+  float floor = 0.0f;               // Weight added to every column
+
+  boardMan->shapeBoard(theBoard);   // Full columns with the locks stamped in
+
+  for (int type = CORNER; type <= INNER; type++)
+  { // Sample each piece type on its own so pieces stay in their slot type
+
+    std::vector<int>* slots = boardMan->getFreeSlots(type);
+
+    if (model[type].empty())
+    { // Every piece of the type is locked in place
+      continue;
+    }
+
+    rotations = getRotations(type);
+    cols = (int)columnPieces[type].size() * rotations;
+    floor = EDAFLOOR / cols;
+
+    worker->avail.assign(cols, 1.0f);
+    worker->weights.resize(cols);
+    worker->order.resize(slots->size());
+    std::iota(worker->order.begin(), worker->order.end(), 0);
+    std::shuffle(worker->order.begin(), worker->order.end(),
+                 worker->generator);
+
+    for (int row : worker->order)
+    { // Draw a piece and rotation that is still unused for each slot
+
+      const float* chances = &model[type][row * cols];
+      const float* avail = worker->avail.data();
+      float* weights = worker->weights.data();
+
+      total = 0.0f;
+
+      for (int c = 0; c < cols; c++)
+      { // Weight every column, used pieces weigh nothing. Kept branch free
+        // so the compiler can vectorise it
+        weights[c] = (chances[c] + floor) * avail[c];
+        total += weights[c];
+      }
+
+      spin = std::uniform_real_distribution<float>(0.0f, total)(
+               worker->generator);
+
+      for (int c = 0; c < cols; c++)
+      { // Walk the weights until the spin is passed, only stopping on
+        // columns of unused pieces
+        if (weights[c] > 0.0f)
+        {
+          choice = c;
+          spin -= weights[c];
+
+          if (spin < 0.0f)
+          {
+            break;
+          }
+        }
+      }
+
+      boardMan->getSlotIndex((*slots)[row], index);
+
+      PackedPiece* slot = &theBoard->boardVecs[index[0]][index[1]];
+
+      slot->pieceID = columnPieces[type][choice / rotations];
+      slot->orientation = choice % rotations;
+      boardMan->fixOrien(slot, index[0], index[1]);
+
+      for (int r = 0; r < rotations; r++)
+      { // The piece can not be used again in this board
+        worker->avail[(choice / rotations) * rotations + r] = 0.0f;
+      }
+    }
+  }
+
+  boardMan->hashBoard(theBoard);    // Pieces changed, rehash the board
+
+} // sampleBoard()
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Title        : EDASolver.h
+// Purpose      : Samples boards from a model learnt from the best boards
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#define EDATOP   0.2            // Fraction of the population learnt from
+#define EDARATE  0.3f           // Weight given to the newest generation
+#define EDAFLOOR 0.05f          // Share of each draw spread over every choice
+
+
+#include "ModelSolver.h"        // Elite carry over and threaded filling
+#include <vector>               // Model, columns and scratch space
+#include <random>               // Random numbers of each worker
+
+
+struct EDAWorker
+{ // Holds what one sampling thread needs, so threads share nothing that they
+  // write to apart from the boards they fill
+
+  std::mt19937 generator;       // Random numbers of this thread
+  std::vector<float> avail;     // 1 for each column of an unused piece
+  std::vector<float> weights;   // Weight of each column for the slot
+  std::vector<int> order;       // Order the slots of a type are filled in
+
+}; // EDAWorker
+
+
+class EDASolver : public ModelSolver
+{
+
+private:
+  // Chance of each piece and rotation in each free slot for each piece type.
+  // Rows are the free slots of the type in free slot order, columns are the
+  // free pieces of the type times the rotations a piece of the type can take
+  std::vector<std::vector<float>> model;
+
+  // How often each column was seen in each row in the best boards
+  std::vector<std::vector<float>> counts;
+
+  // Piece ID of each piece column of each piece type
+  std::vector<std::vector<int>> columnPieces;
+
+  // Piece column of each piece ID within its piece type, -1 if locked
+  std::vector<int> pieceColumns;
+
+  std::vector<EDAWorker> workers;            // One per sampling thread
+
+  // Returns how many rotations a piece of the type given can take in a slot,
+  // border pieces always face the edge so only inner pieces turn
+  inline int getRotations(int type)          // *In*
+  {
+    return (type == INNER) ? 4 : 1;          // Return rotations of type
+  } // getRotations()
+
+  // Learns from the best EDATOP of the scored population, blending how often
+  // each piece and rotation was seen in each slot in to the model
+  void learn(int popSize);                   // *In*
+
+  // Fills every free slot of the board with a piece and rotation drawn from
+  // the model. Each piece is used once, slots are filled in a random order
+  // so no slot always gets the first choice
+  void sampleBoard(Board* theBoard,          // *In-Out*
+                   EDAWorker* worker);       // *In-Out*
+
+public:
+  // Stores the board manager of the solver and makes a worker for each
+  // hardware thread
+  EDASolver(BoardManager* manager);          // *In*
+
+  // Sets every choice of the model to the same chance and seeds the workers.
+  // Called once the locks are built and whenever the population restarts
+  void reset();
+
+  // Learns from the scored population then replaces it with boards sampled
+  // from the model, keeping the best eliteRate boards as they are
+  void doGeneration(int popSize,             // *In*
+                    int eliteRate);          // *In*
+
+}; // EDASolver
\ No newline at end of file
@@ -0,0 +1,437 @@
+// Title        : ExhaustiveSolver.cpp
+// Purpose      : Searches every arrangement of the pieces for solutions
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#include "ExhaustiveSolver.h"   // Class declaration
+#include <algorithm>            // max()
+#include <chrono>               // Timing the search
+#include <thread>               // Search threads
+
+
+ExhaustiveSolver::ExhaustiveSolver(BoardManager* manager)   // *In*
+{ // Stores the board manager of the solver and makes a worker for each
+  // hardware thread
+
+  boardMan = manager;               // Board manager of the solver
+  rootCorner = -1;                  // Any corner may go top left
+  keepCount = 0;                    // Keep no solutions
+  nodeCount = 0;                    // No placements tried yet
+  solutionCount = 0;                // No solutions found yet
+  seconds = 0.0;                    // No search run yet
+  timeLimit = 0;                    // No time limit
+  stopFlag = nullptr;               // Nothing to stop the search
+  isStopped = false;                // Not stopped
+
+  // One worker per hardware thread, at least one if the count is unknown
+  for (unsigned int i = 0;
+       i < std::max(1u, std::thread::hardware_concurrency()); i++)
+  {
+    workers.push_back(std::unique_ptr<SearchWorker>(new SearchWorker()));
+  }
+
+} // ExhaustiveSolver()
+
+
+void ExhaustiveSolver::solve(int keep,                      // *In*
+                             int limit,                     // *In*
+                             volatile std::sig_atomic_t* flag)  // *In*
+{ // Searches every arrangement of the free pieces for solutions, keeping the
+  // first keep found. With no locked pieces only one corner is tried in the
+  // top left slot, so each solution is found once instead of once per turn.
+  // Stops early once the stop flag given is set or the time limit in seconds
+  // passes (0 for none), keeping the counts and solutions found so far
+
+  std::vector<std::vector<PuzzlePiece>>* pieces =
+    boardMan->getPieces();          // Pieces of each type
+  std::vector<std::thread> threads; // Running search threads
+  int size = boardMan->getSize();   // Last index of board
+
+  start = std::chrono::steady_clock::now();
+  timeLimit = limit;
+  stopFlag = flag;
+  isStopped = false;
+  keepCount = keep;
+  solutions.clear();
+  order.clear();
+
+  for (int yIndex = 0; yIndex <= size; yIndex++)
+  { // Search each row from the top
+    for (int xIndex = 0; xIndex <= size; xIndex++)
+    { // Search each slot of the row from the left
+      order.push_back({ xIndex, yIndex });
+    }
+  }
+
+  rootCorner = -1;
+
+  if (boardMan->getLocks()->empty())
+  { // Each solution turned four ways puts each corner top left once, so
+    // trying only the lowest corner ID there finds each solution once
+    rootCorner = (*pieces)[CORNER][0].pieceID;
+
+    for (const PuzzlePiece& piece : (*pieces)[CORNER])
+    {
+      rootCorner = std::min(rootCorner, piece.pieceID);
+    }
+  }
+
+  for (std::unique_ptr<SearchWorker>& worker : workers)
+  { // Every worker starts with no tasks and an empty board
+    worker->tasks.clear();
+    worker->candidates.assign(order.size(), std::vector<PieceRef>());
+    worker->nodes = 0;
+    worker->solutions = 0;
+    clearWorker(worker.get());
+  }
+
+  splitTasks();                     // Deal out the top of the search tree
+
+  for (int i = 0; i < (int)workers.size(); i++)
+  { // Start a thread for each worker
+    threads.push_back(std::thread(&ExhaustiveSolver::runWorker, this, i));
+  }
+
+  nodeCount = 0;
+  solutionCount = 0;
+
+  for (int i = 0; i < (int)threads.size(); i++)
+  { // Wait for every worker to run out of tasks then add up its counts
+    threads[i].join();
+    nodeCount += workers[i]->nodes;
+    solutionCount += workers[i]->solutions;
+  }
+
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          start).count();
+
+} // solve()
+
+
+void ExhaustiveSolver::clearWorker(SearchWorker* worker)    // *In-Out*
+{ // Empties the board of the worker given back to the locked pieces and marks
+  // only the locked pieces as used
+
+  boardMan->shapeBoard(&worker->theBoard);  // Stamp the locks in
+
+  worker->isUsed.assign((*boardMan->getPieces())[CORNER].size() +
+                        (*boardMan->getPieces())[EDGE].size() +
+                        (*boardMan->getPieces())[INNER].size() + 1, 0);
+
+  for (const LockedSlot& lock : *boardMan->getLocks())
+  { // Locked pieces are already on the board
+    worker->isUsed[lock.pieceID] = 1;
+  }
+
+} // clearWorker()
+
+
+void ExhaustiveSolver::applyTask(SearchWorker* worker,      // *In-Out*
+                                 const SearchTask& task)    // *In*
+{ // Places the pieces of the task given in the board of the worker given
+
+  clearWorker(worker);
+
+  for (int i = 0; i < (int)task.placed.size(); i++)
+  { // Put each piece of the task in its slot of the scan order
+    PackedPiece* slot =
+      &worker->theBoard.boardVecs[order[i][0]][order[i][1]];
+
+    slot->pieceID = task.placed[i].pieceID;
+    slot->orientation = task.placed[i].orientation;
+    worker->isUsed[task.placed[i].pieceID] = 1;
+  }
+
+} // applyTask()
+
+
+void ExhaustiveSolver::findCandidates(SearchWorker* worker, // *In*
+                                      int depth,            // *In*
+                                      std::vector<PieceRef>* candidates)
+{ // Fills candidates with every piece and rotation that can go in the slot at
+  // the depth given, matching the pieces to the left and above along with any
+  // locked pieces to the right and below. Locked slots give their own piece
+  // if it matches
+
+  Board* theBoard = &worker->theBoard;  // Board being searched
+  int size = boardMan->getSize();       // Last index of board
+  int xIndex = order[depth][0];         // X index of the slot
+  int yIndex = order[depth][1];         // Y index of the slot
+  int type = boardMan->getSlotType(xIndex, yIndex);  // Type the slot holds
+  int left = boardMan->getEdgeColour();  // Colour the left must have
+  int top = boardMan->getEdgeColour();   // Colour the top must have
+  int right = -1;                   // Colour of a locked piece to the right
+  int bottom = -1;                  // Colour of a locked piece below
+  std::vector<PieceRef>* matches = nullptr;  // Pieces with both colours
+  PackedPiece turned;               // Border piece turned to fit the slot
+  PieceRef ref;                     // Piece of a locked slot
+
+  candidates->clear();
+
+  if (xIndex > 0)
+  { // Slot to the left is always filled before this one
+    left = boardMan->getPattern(theBoard, xIndex - 1, yIndex, RIGHT);
+  }
+
+  if (yIndex > 0)
+  { // Slot above is always filled before this one
+    top = boardMan->getPattern(theBoard, xIndex, yIndex - 1, BOTTOM);
+  }
+
+  if (boardMan->isLocked(xIndex, yIndex))
+  { // Locked slots can only hold their own piece, if it matches
+
+    if (boardMan->getPattern(theBoard, xIndex, yIndex, LEFT) == left &&
+        boardMan->getPattern(theBoard, xIndex, yIndex, TOP) == top)
+    {
+      ref.pieceID = theBoard->boardVecs[xIndex][yIndex].pieceID;
+      ref.orientation = theBoard->boardVecs[xIndex][yIndex].orientation;
+      candidates->push_back(ref);
+    }
+
+    return;
+  }
+
+  if (xIndex < size && boardMan->isLocked(xIndex + 1, yIndex))
+  { // A locked piece to the right has to be matched as well
+    right = boardMan->getPattern(theBoard, xIndex + 1, yIndex, LEFT);
+  }
+
+  if (yIndex < size && boardMan->isLocked(xIndex, yIndex + 1))
+  { // A locked piece below has to be matched as well
+    bottom = boardMan->getPattern(theBoard, xIndex, yIndex + 1, TOP);
+  }
+
+  matches = boardMan->getColourMatches(type, left, top);
+
+  if (matches == nullptr)
+  { // No piece has these colours
+    return;
+  }
+
+  for (const PieceRef& match : *matches)
+  { // Keep the unused pieces that fit every side that has to match
+
+    if (worker->isUsed[match.pieceID] ||
+        (depth == 0 && rootCorner != -1 && match.pieceID != rootCorner))
+    {
+      continue;
+    }
+
+    if (type != INNER)
+    { // Border pieces only in the rotation that puts their edge against the
+      // edge of the board
+      turned.pieceID = match.pieceID;
+      turned.orientation = 0;
+      boardMan->fixOrien(&turned, xIndex, yIndex);
+
+      if ((int)turned.orientation != match.orientation)
+      {
+        continue;
+      }
+    }
+
+    if ((right != -1 &&
+         boardMan->getSegment(match.pieceID, match.orientation, RIGHT) !=
+           right) ||
+        (bottom != -1 &&
+         boardMan->getSegment(match.pieceID, match.orientation, BOTTOM) !=
+           bottom))
+    {
+      continue;
+    }
+
+    candidates->push_back(match);
+  }
+
+} // findCandidates()
+
+
+void ExhaustiveSolver::splitTasks()
+{ // Splits the top of the search tree breadth first until there are
+  // TASKSPERWORKER tasks for each worker, then deals them out in turn
+
+  std::deque<SearchTask> split(1);  // Tasks at the current depth
+  SearchWorker* scratch = workers[0].get();  // Board to expand tasks in
+  SearchTask child;                 // Task one slot deeper
+  int depth = 0;                    // Slots placed by every task
+  int count = 0;                    // Tasks at the current depth
+
+  while (depth < (int)order.size() - 1 && !split.empty() &&
+         split.size() < workers.size() * TASKSPERWORKER)
+  { // Expand every task by one slot
+
+    count = (int)split.size();
+
+    for (int i = 0; i < count; i++)
+    { // Replace each task with one task for each candidate of its next slot
+      applyTask(scratch, split.front());
+      findCandidates(scratch, depth, &scratch->candidates[depth]);
+      scratch->nodes += scratch->candidates[depth].size();
+
+      for (const PieceRef& ref : scratch->candidates[depth])
+      {
+        child.placed = split.front().placed;
+        child.placed.push_back(ref);
+        split.push_back(child);
+      }
+
+      split.pop_front();
+    }
+
+    depth++;
+  }
+
+  for (int i = 0; !split.empty(); i++)
+  { // Deal the tasks out to the workers in turn
+    workers[i % workers.size()]->tasks.push_back(split.front());
+    split.pop_front();
+  }
+
+} // splitTasks()
+
+
+bool ExhaustiveSolver::nextTask(int self,                   // *In*
+                                SearchTask* task)           // *Out*
+{ // Takes the newest task of the worker given, or steals the oldest task of
+  // another worker if it has none. Returns whether a task was found
+
+  bool isFound = false;             // Holds if a task was found
+  int victim = self;                // Worker the task is taken from
+
+  for (int i = 0; i < (int)workers.size() && !isFound; i++)
+  { // Try the worker itself first, then every other worker in turn
+
+    SearchWorker* other = workers[victim].get();
+    std::lock_guard<std::mutex> guard(other->taskLock);
+
+    if (!other->tasks.empty())
+    { // Own tasks come off the back, stolen tasks off the front so the
+      // thief takes the task that has been waiting longest
+      isFound = true;
+
+      if (victim == self)
+      {
+        *task = std::move(other->tasks.back());
+        other->tasks.pop_back();
+      }
+      else
+      {
+        *task = std::move(other->tasks.front());
+        other->tasks.pop_front();
+      }
+    }
+
+    victim = (victim + 1) % (int)workers.size();
+  }
+
+  return isFound;                   // Return whether a task was found
+
+} // nextTask()
+
+
+void ExhaustiveSolver::runWorker(int self)                  // *In*
+{ // Searches tasks until there are none left in any deque or the search is
+  // stopped. Tasks are never split further once searching starts, so empty
+  // deques mean the end
+
+  SearchWorker* worker = workers[self].get();  // Worker of this thread
+  SearchTask task;                  // Task being searched
+
+  while (!isStopped && nextTask(self, &task))
+  { // Place the pieces of the task then search the slots after them
+    applyTask(worker, task);
+    search(worker, (int)task.placed.size());
+  }
+
+} // runWorker()
+
+
+void ExhaustiveSolver::search(SearchWorker* worker,         // *In-Out*
+                              int depth)                    // *In*
+{ // Tries every candidate in the slot at the depth given then searches the
+  // slots after it, counting a solution when every slot is filled
+
+  std::vector<PieceRef>* candidates = nullptr;  // Choices for the slot
+  bool isLocked = false;            // Whether the slot holds a lock
+
+  if (depth == (int)order.size())
+  { // Every slot is filled and matched
+    worker->solutions++;
+
+    if (worker->solutions <= keepCount)
+    { // More than keepCount from one worker means the kept list is full
+      keepSolution(worker);
+    }
+    return;
+  }
+
+  candidates = &worker->candidates[depth];
+  findCandidates(worker, depth, candidates);
+  isLocked = boardMan->isLocked(order[depth][0], order[depth][1]);
+
+  for (const PieceRef& ref : *candidates)
+  { // Place each candidate and search on from it
+
+    PackedPiece* slot =
+      &worker->theBoard.boardVecs[order[depth][0]][order[depth][1]];
+
+    worker->nodes++;
+
+    if ((worker->nodes & (STOPPOLL - 1)) == 0)
+    { // Every so often check whether the search has to stop
+      checkStop();
+    }
+
+    if (!isLocked)
+    { // Locked pieces are already in place and marked used
+      slot->pieceID = ref.pieceID;
+      slot->orientation = ref.orientation;
+      worker->isUsed[ref.pieceID] = 1;
+    }
+
+    search(worker, depth + 1);
+
+    if (!isLocked)
+    { // Free the piece for the next candidate
+      worker->isUsed[ref.pieceID] = 0;
+    }
+
+    if (isStopped)
+    { // Leave the rest of the tree unsearched
+      break;
+    }
+  }
+
+} // search()
+
+
+void ExhaustiveSolver::keepSolution(SearchWorker* worker)   // *In*
+{ // Keeps a copy of the solved board of the worker given while fewer than
+  // keepCount solutions are kept
+
+  std::lock_guard<std::mutex> guard(solutionLock);  // Solutions are shared
+
+  if ((int)solutions.size() < keepCount)
+  { // Copy the board and give it a hash of its own
+    solutions.push_back(worker->theBoard);
+    solutions.back().boardID = (int)solutions.size();
+    boardMan->hashBoard(&solutions.back());
+  }
+
+} // keepSolution()
+
+
+void ExhaustiveSolver::checkStop()
+{ // Tells every worker to stop if the stop flag has been set or the time
+  // limit has passed
+
+  if ((stopFlag != nullptr && *stopFlag) ||
+      (timeLimit > 0 && std::chrono::duration<double>(
+         std::chrono::steady_clock::now() - start).count() >= timeLimit))
+  {
+    isStopped = true;
+  }
+
+} // checkStop()
\ No newline at end of file
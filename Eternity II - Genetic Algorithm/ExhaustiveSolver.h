@@ -0,0 +1,156 @@
+// Title        : ExhaustiveSolver.h
+// Purpose      : Searches every arrangement of the pieces for solutions
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#define TASKSPERWORKER 64       // Tasks split off per worker before searching
+#define STOPPOLL 1048576        // Placements between checks for a stop, a
+                                // power of two
+
+
+#include "BoardManager.h"       // Pieces, locks and board definition
+#include <vector>               // Slot order, candidates and solutions
+#include <deque>                // Task deque of each worker
+#include <memory>               // unique_ptr()
+#include <mutex>                // Guarding task deques and solutions
+#include <atomic>               // Stop flag shared by the workers
+#include <chrono>               // Time limit of the search
+#include <csignal>              // Type of the interrupt flag
+
+
+struct SearchTask
+{ // Holds the pieces and rotations placed in the first slots of the scan
+  // order, the root of the part of the search tree a task covers
+
+  std::vector<PieceRef> placed;     // Piece placed in each slot so far
+
+}; // SearchTask
+
+
+struct SearchWorker
+{ // Holds what one search thread needs. The board, used pieces and
+  // candidates are only touched by the thread itself, the task deque is
+  // locked only when a task is taken from it
+
+  Board theBoard;                               // Board being searched
+  std::vector<char> isUsed;                     // Whether piece ID is placed
+  std::vector<std::vector<PieceRef>> candidates;  // Choices at each depth
+  std::deque<SearchTask> tasks;                 // Tasks left to search
+  std::mutex taskLock;                          // Guards the task deque
+  long long nodes;                              // Placements tried
+  long long solutions;                          // Solutions found
+
+}; // SearchWorker
+
+
+class ExhaustiveSolver
+{
+
+private:
+  BoardManager* boardMan;                    // Board manager of the solver
+  int rootCorner;                            // Only corner tried top left
+  int keepCount;                             // Solutions kept for output
+  std::vector<std::vector<int>> order;       // Every slot in scan order
+  std::vector<std::unique_ptr<SearchWorker>> workers;  // One per thread
+  std::mutex solutionLock;                   // Guards the kept solutions
+  std::vector<Board> solutions;              // First solutions found
+  long long nodeCount;                       // Placements tried by all
+  long long solutionCount;                   // Solutions found by all
+  double seconds;                            // Time the search took
+  int timeLimit;                             // Seconds allowed, 0 for any
+  volatile std::sig_atomic_t* stopFlag;      // Set when interrupted
+  std::chrono::steady_clock::time_point start;  // Time the search started
+  std::atomic<bool> isStopped;               // Whether workers should stop
+
+  // Empties the board of the worker given back to the locked pieces and
+  // marks only the locked pieces as used
+  void clearWorker(SearchWorker* worker);    // *In-Out*
+
+  // Places the pieces of the task given in the board of the worker given
+  void applyTask(SearchWorker* worker,       // *In-Out*
+                 const SearchTask& task);    // *In*
+
+  // Fills candidates with every piece and rotation that can go in the slot at
+  // the depth given, matching the pieces to the left and above along with any
+  // locked pieces to the right and below. Locked slots give their own piece
+  // if it matches
+  void findCandidates(SearchWorker* worker,                 // *In*
+                      int depth,                            // *In*
+                      std::vector<PieceRef>* candidates);   // *Out*
+
+  // Splits the top of the search tree breadth first until there are
+  // TASKSPERWORKER tasks for each worker, then deals them out in turn
+  void splitTasks();
+
+  // Takes the newest task of the worker given, or steals the oldest task of
+  // another worker if it has none. Returns whether a task was found
+  bool nextTask(int self,                    // *In*
+                SearchTask* task);           // *Out*
+
+  // Searches tasks until there are none left in any deque or the search is
+  // stopped
+  void runWorker(int self);                  // *In*
+
+  // Tries every candidate in the slot at the depth given then searches the
+  // slots after it, counting a solution when every slot is filled
+  void search(SearchWorker* worker,          // *In-Out*
+              int depth);                    // *In*
+
+  // Keeps a copy of the solved board of the worker given while fewer than
+  // keepCount solutions are kept
+  void keepSolution(SearchWorker* worker);   // *In*
+
+  // Tells every worker to stop if the stop flag has been set or the time
+  // limit has passed
+  void checkStop();
+
+public:
+  // Stores the board manager of the solver and makes a worker for each
+  // hardware thread
+  ExhaustiveSolver(BoardManager* manager);   // *In*
+
+  // Searches every arrangement of the free pieces for solutions, keeping the
+  // first keep found. With no locked pieces only one corner is tried in the
+  // top left slot, so each solution is found once instead of once per turn.
+  // Stops early once the stop flag given is set or the time limit in seconds
+  // passes (0 for none), keeping the counts and solutions found so far
+  void solve(int keep,                               // *In*
+             int limit,                              // *In*
+             volatile std::sig_atomic_t* flag);      // *In*
+
+  // Returns whether the last search was stopped before the whole tree was
+  // searched
+  inline bool getIsStopped()
+  {
+    return isStopped;      // Return whether the search was stopped
+  } // getIsStopped()
+
+  // Returns the solutions kept by the last search
+  inline std::vector<Board>* getSolutions()
+  {
+    return &solutions;     // Return the kept solutions
+  } // getSolutions()
+
+  // Returns how many solutions the last search found
+  inline long long getSolutionCount()
+  {
+    return solutionCount;  // Return the solutions found
+  } // getSolutionCount()
+
+  // Returns how many placements the last search tried
+  inline long long getNodeCount()
+  {
+    return nodeCount;      // Return the placements tried
+  } // getNodeCount()
+
+  // Returns how many seconds the last search took
+  inline double getSeconds()
+  {
+    return seconds;        // Return the time taken
+  } // getSeconds()
+
+}; // ExhaustiveSolver
\ No newline at end of file
@@ -11,15 +11,14 @@
 #include <windows.h>        // Include file directory functions
 
 
-// Initialise output file string
-std::string FileHandler::outFilename = "/0";
-
-
-FileHandler::FileHandler()
+FileHandler::FileHandler(BoardManager* manager)  // *In*
 { // Calls to the file directory for available piece data files, make sure
   // puzzle piece vector is initialised
 
-  if (BoardManager::getInstance()->getPieces()->size() == 0)
+  boardMan = manager;             // Board manager of the solver
+  outFilename = "/0";             // Initialise output file string
+
+  if (boardMan->getPieces()->size() == 0)
   { // Make sure puzzle piece vector is initialised before pushing
 
     for (int i = 0; i < 3; i++)
@@ -28,7 +27,7 @@ FileHandler::FileHandler()
       std::vector<PuzzlePiece> newCol;    // Create a new vector for board
 
       // Push vector on to vector of vectors
-      BoardManager::getInstance()->getPieces()->push_back(newCol);
+      boardMan->getPieces()->push_back(newCol);
     }
   }
 
@@ -38,15 +37,7 @@ FileHandler::FileHandler()
 } // FileReader()
 
 
-void FileHandler::readSettingsFile(int* boardSize,               // *Out*
-                                   int* patternNum,              // *Out*
-                                   int* popSize,                 // *Out*
-                                   SelectionType* selectMethod,  // *Out*
-                                   CrossoverType* crossMethod,   // *Out*
-                                   MutateType* mutMethod,        // *Out*
-                                   double* mutRate,              // *Out*
-                                   int* eliteRate,               // *Out*
-                                   bool* isStartPiece,           // *Out*
+void FileHandler::readSettingsFile(Settings* settings,           // *Out*
                                    bool* isSuccess)              // *Out*
 { // Reads the settings file named "settings.ini" in the root directory, 
   // setting the appropriate values that have been read in to the algorithm
@@ -60,6 +51,18 @@ void FileHandler::readSettingsFile(int* boardSize,               // *Out*
   double inMutRate = -1;    // Holds input mutation rate
   int inElite = -1;         // Holds input elitism rate
   int startPiece = -1;      // Holds parsed int for start piece constraint
+  int inRestart = -1;       // Holds input restart policy
+  int inMode = -1;          // Holds input GA mode
+  int inTournament = -1;    // Holds input tournament size
+  int inSolver = -1;        // Holds input solver mode
+  int inBatch = -1;         // Holds parsed int for batch fitness checks
+  int inBias = -1;          // Holds parsed int for mismatch biased mutation
+  int inSolutions = -1;     // Holds input distinct solutions to find
+  int inGenerator = -1;     // Holds parsed int for corpus generation
+  int inTime = -1;          // Holds input time limit in seconds
+  int inGenLimit = -1;      // Holds input generation limit
+  int inEvalLimit = -1;     // Holds input evaluation limit
+  int inTarget = -1;        // Holds input target match percentage
 
   if (openFile("settings.ini"))
   { // Checks to see if the file is open before proceeding with reading of the
@@ -75,26 +78,56 @@ void FileHandler::readSettingsFile(int* boardSize,               // *Out*
     parseInt(&inElite, "EliteRate:");          // Parse the elitism rate
     parseInt(&startPiece, "StartConstraint:"); // Parse start constraint active
 
+    // Settings added since the first release take their default when they
+    // are missing, so settings files written before them still load
+    parseOptional(&inRestart, "RestartPolicy:", FULLRESTART);
+    parseOptional(&inMode, "GAMode:", GENERATIONAL);
+    parseOptional(&inTournament, "TournamentSize:",
+                  (inPopSize < TOURNAMENTDEFAULT) ? inPopSize :
+                                                    TOURNAMENTDEFAULT);
+    parseOptional(&inSolver, "SolverMode:", GASOLVER);
+    parseOptional(&inBatch, "BatchFitness:", 0);
+    parseOptional(&inBias, "MismatchBias:", 0);
+    parseOptional(&inSolutions, "SolutionCount:", 1);
+    parseOptional(&inGenerator, "Generator:", 0);
+    parseOptional(&inTime, "TimeLimit:", 0);
+    parseOptional(&inGenLimit, "GenerationLimit:", 0);
+    parseOptional(&inEvalLimit, "EvaluationLimit:", 0);
+    parseOptional(&inTarget, "TargetMatch:", 100);
+
     theFile.close();                     // Close file after use
   } // if (openFile("settings.ini"))
 
   if (CheckInput(inSize, inPattern, inPopSize, inSelect, inCross, inMutMethod,
-                 inMutRate, inElite, startPiece))
+                 inMutRate, inElite, startPiece, inRestart, inMode,
+                 inTournament, inSolver, inBatch, inBias, inSolutions,
+                 inGenerator, inTime, inGenLimit, inEvalLimit, inTarget))
   { // Check to see if the input that has been read in is valid. If the input
     // is valid, set the data members of the GA to the input
 
-    *boardSize = inSize;               // Set the board size
-    *patternNum = inPattern;           // Set the number of patterns
-    *popSize = inPopSize;              // Set the population size
+    settings->boardSize = inSize;              // Set the board size
+    settings->patternNum = inPattern;          // Set the number of patterns
+    settings->popSize = inPopSize;             // Set the population size
 
     // Parse the input ints into the enums of the selection, crossover and 
-    // mutation methods
-    parseMethods(inSelect, inCross, inMutMethod, selectMethod, crossMethod,
-                 mutMethod);
-
-    *mutRate = inMutRate;              // Set the mutation rate
-    *eliteRate = inElite;              // Set the elitism rate
-    *isStartPiece = (startPiece == 1); // Set if start piece is active
+    // mutation methods, the restart policy, the GA mode and the solver mode
+    parseMethods(inSelect, inCross, inMutMethod, &settings->selectMethod,
+                 &settings->crossMethod, &settings->mutMethod, inRestart,
+                 &settings->restartMethod, inMode, &settings->gaMode,
+                 inSolver, &settings->solverMode);
+
+    settings->mutRate = inMutRate;             // Set the mutation rate
+    settings->eliteRate = inElite;             // Set the elitism rate
+    settings->isStartPiece = (startPiece == 1);// Set if start piece is active
+    settings->tournamentSize = inTournament;   // Set the tournament size
+    settings->isBatchFitness = (inBatch == 1); // Set if batch checks active
+    settings->isMismatchBias = (inBias == 1);  // Set if mismatch bias active
+    settings->solutionCount = inSolutions;     // Set the solutions to find
+    settings->isGenerator = (inGenerator == 1);// Set if generator active
+    settings->timeLimit = inTime;              // Set the time limit
+    settings->generationLimit = inGenLimit;    // Set the generation limit
+    settings->evaluationLimit = inEvalLimit;   // Set the evaluation limit
+    settings->targetMatch = inTarget;          // Set the target match
   }
   else
   { // If input is not valid, set success to false and set settings to 
@@ -122,7 +155,19 @@ bool FileHandler::CheckInput(int inSize,                         // *In*
                              int inMutMethod,                    // *In*
                              double inMutRate,                   // *In*
                              int inElite,                        // *In*
-                             int startPiece)                     // *In*
+                             int startPiece,                     // *In*
+                             int inRestart,                      // *In*
+                             int inMode,                         // *In*
+                             int inTournament,                   // *In*
+                             int inSolver,                       // *In*
+                             int inBatch,                        // *In*
+                             int inBias,                         // *In*
+                             int inSolutions,                    // *In*
+                             int inGenerator,                    // *In*
+                             int inTime,                         // *In*
+                             int inGenLimit,                     // *In*
+                             int inEvalLimit,                    // *In*
+                             int inTarget)                       // *In*
 { // Checks all of the input that has been read in make sure they are valid
   // inputs
 
@@ -141,8 +186,8 @@ bool FileHandler::CheckInput(int inSize,                         // *In*
     // set to failed input
     result = false;
   }
-  else if (inSelect < 0 || inSelect > 1)
-  { // If the selection method is less than 0 or greater than 1, set to failed 
+  else if (inSelect < 0 || inSelect > 2)
+  { // If the selection method is less than 0 or greater than 2, set to failed 
     // input
     result = false;
   }
@@ -151,8 +196,8 @@ bool FileHandler::CheckInput(int inSize,                         // *In*
     // input
     result = false;
   }
-  else if (inMutMethod < 0 || inMutMethod > 4)
-  { // If the mutation method is less than 0 or greather than 4, set to failed 
+  else if (inMutMethod < 0 || inMutMethod > 7)
+  { // If the mutation method is less than 0 or greather than 7, set to failed 
     // input
     result = false;
   }
@@ -170,6 +215,50 @@ bool FileHandler::CheckInput(int inSize,                         // *In*
     // 16, set to failed input
     result = false;
   }
+  else if (inRestart < 0 || inRestart > 2)
+  { // If the restart policy is less than 0 or greater than 2, set to failed
+    // input
+    result = false;
+  }
+  else if (inMode < 0 || inMode > 3)
+  { // If the GA mode is less than 0 or greater than 3, set to failed input
+    result = false;
+  }
+  else if (inTournament < 2 || inTournament > inPopSize)
+  { // If the tournament size is less than 2 or greater than the population
+    // size, set to failed input
+    result = false;
+  }
+  else if (inSolver < 0 || inSolver > 4)
+  { // If the solver mode is less than 0 or greater than 4, set to failed input
+    result = false;
+  }
+  else if (inBatch != 0 && inBatch != 1)
+  { // If batch fitness is not set to 0 or 1, set to failed input
+    result = false;
+  }
+  else if (inBias != 0 && inBias != 1)
+  { // If mismatch bias is not set to 0 or 1, set to failed input
+    result = false;
+  }
+  else if (inSolutions < 1)
+  { // If the solutions to find is less than 1, set to failed input
+    result = false;
+  }
+  else if (inGenerator != 0 && inGenerator != 1)
+  { // If generator is not set to 0 or 1, set to failed input
+    result = false;
+  }
+  else if (inTime < 0 || inGenLimit < 0 || inEvalLimit < 0)
+  { // If the time, generation or evaluation limit is less than 0, set to
+    // failed input
+    result = false;
+  }
+  else if (inTarget < 1 || inTarget > 100)
+  { // If the target match is less than 1 or greater than 100, set to failed
+    // input
+    result = false;
+  }
 
   return result;        // Return the result
 
@@ -197,8 +286,16 @@ void FileHandler::readDataFile(int size,                         // *In*
 
       while (std::getline(theFile, inLine))
       { // While getline actually returns a line of data, proceed with parsing
-        parseData(inLine, parsedData);    // Parse piece data
-        createPiece(parsedData);          // Create new piece with data
+
+        if (!inLine.empty() && inLine[0] == HINTLABEL)
+        { // If the line is a hint, lock the piece in its slot
+          parseHint(inLine);
+        }
+        else
+        { // Otherwise the line is a piece
+          parseData(inLine, parsedData);    // Parse piece data
+          createPiece(parsedData);          // Create new piece with data
+        }
       }
 
       theFile.close();                             // Close the file after use
@@ -210,6 +307,15 @@ void FileHandler::readDataFile(int size,                         // *In*
     makeDataFile(size, pattern);
   }
 
+  // Store the pieces by ID so boards only need to hold IDs and rotations
+  boardMan->buildPieceTable();
+
+  // Index the pieces by colour for guided mutation
+  boardMan->buildColourIndex();
+
+  // Make the keys used to hash boards for diversity tracking
+  boardMan->buildZobristTable();
+
 } // readDataFile()
 
 
@@ -223,12 +329,248 @@ void FileHandler::outputBoard(Board* theBoard,                   // *In*
 
     outputMatches(theBoard, genCount);   // Output board with pattern IDs
     outputIDs(theBoard, genCount);       // Output board with piece IDs 
+
+    if (!boardMan->getHeatmap()->empty())
+    { // If the mismatch heatmap is being kept, output it with the board
+      writeHeatmap(genCount);
+    }
+
     theFile.close();                     // Close the file after use
   }
 
 } // outputBoard()
 
 
+void FileHandler::outputHeatmap(int genCount)                    // *In*
+{ // Appends the mismatch heatmap of the generation to the output file
+
+  if (openFile(outFilename.c_str()))
+  { // If output file opened successfully output the heatmap
+    writeHeatmap(genCount);
+    theFile.close();                     // Close the file after use
+  }
+
+} // outputHeatmap()
+
+
+void FileHandler::readGeneratorFile(GeneratorSettings* corpus,   // *Out*
+                                    bool* isSuccess)             // *Out*
+{ // Reads the generator file named "generator.ini" in the root directory,
+  // success is set to false if the file is missing or a setting is not valid
+
+  int inOfficial = -1;      // Holds parsed int for official style colours
+  int inBinary = -1;        // Holds parsed int for binary output
+
+  corpus->minSize = -1;
+  corpus->maxSize = -1;
+  corpus->minPatterns = -1;
+  corpus->maxPatterns = -1;
+  corpus->puzzleCount = -1;
+  corpus->seed = -1;
+
+  if (openFile("generator.ini"))
+  { // Checks to see if the file is open before proceeding with reading of the
+    // file
+
+    parseInt(&corpus->minSize, "MinSize:");         // Parse smallest size
+    parseInt(&corpus->maxSize, "MaxSize:");         // Parse largest size
+    parseInt(&corpus->minPatterns, "MinPatterns:"); // Parse fewest patterns
+    parseInt(&corpus->maxPatterns, "MaxPatterns:"); // Parse most patterns
+    parseInt(&corpus->puzzleCount, "PuzzleCount:"); // Parse puzzles per set
+    parseInt(&corpus->seed, "Seed:");               // Parse corpus seed
+    parseInt(&inOfficial, "OfficialStyle:");        // Parse official style
+    parseInt(&inBinary, "BinaryOutput:");           // Parse binary output
+
+    theFile.close();                     // Close file after use
+  }
+
+  corpus->isOfficialStyle = (inOfficial == 1);  // Set if official style
+  corpus->isBinary = (inBinary == 1);           // Set if binary output
+
+  if (!CheckGenerator(corpus) || (inOfficial != 0 && inOfficial != 1) ||
+      (inBinary != 0 && inBinary != 1))
+  { // If any setting is missing or not valid, set success to false
+    *isSuccess = false;
+  }
+
+} // readGeneratorFile()
+
+
+bool FileHandler::CheckGenerator(GeneratorSettings* corpus)      // *In*
+{ // Checks all of the generator settings that have been read in are valid
+
+  bool result = true;         // Result of input check, changed to false if fail
+
+  if (corpus->minSize < 3 || corpus->maxSize < corpus->minSize)
+  { // If the smallest size is less than 3 or more than the largest size, set
+    // to failed input
+    result = false;
+  }
+  else if (corpus->minPatterns < 1 || corpus->maxPatterns < corpus->minPatterns
+           || corpus->maxPatterns > 255)
+  { // If the fewest patterns is less than 1 or more than the most patterns,
+    // or the most patterns does not fit in a byte, set to failed input
+    result = false;
+  }
+  else if (corpus->puzzleCount < 1)
+  { // If the puzzles per set is less than 1, set to failed input
+    result = false;
+  }
+  else if (corpus->seed < 0)
+  { // If the seed is less than 0, set to failed input
+    result = false;
+  }
+
+  return result;        // Return the result
+
+} // CheckGenerator()
+
+
+void FileHandler::startCorpus()
+{ // Makes the corpus directory and starts a new manifest, replacing any
+  // manifest left by an earlier corpus
+
+  CreateDirectory(L"Corpus", NULL);     // Does nothing if already made
+
+  // Open the manifest emptying it of any earlier corpus
+  theFile.open(CORPUSDIR "manifest.csv", std::ios::out | std::ios::trunc);
+
+  if (theFile.is_open())
+  { // If the manifest was made, write the column names
+    theFile << "File,BoardSize,Patterns,Index,Seed,Style" << std::endl;
+    theFile.close();                     // Close the file after use
+  }
+
+} // startCorpus()
+
+
+void FileHandler::outputPuzzle(GeneratedPuzzle* puzzle,          // *In*
+                               bool isOfficialStyle,             // *In*
+                               bool isBinary)                    // *In*
+{ // Writes the generated puzzle to a .e2 file in the corpus directory, and to
+  // a .e2b binary file as well if binary is on, then adds a line for it to the
+  // manifest so the puzzle can be made again from its seed
+
+  std::string name = "BoardSize ";  // Name of the puzzle without extension
+  char intBuff[12] = "/0";          // Holds result of itoa
+
+  _itoa_s(puzzle->size, intBuff, 10);
+  name += intBuff;                  // Append board size
+  name += " - Pattern ";
+  _itoa_s(puzzle->patternNum, intBuff, 10);
+  name += intBuff;                  // Append pattern num
+  name += " - ";
+  _itoa_s(puzzle->index, intBuff, 10);
+  name += intBuff;                  // Append index within the set
+
+  writePuzzleText(puzzle, CORPUSDIR + name + ".e2");
+
+  if (isBinary)
+  { // If binary output is on, write the binary file as well
+    writePuzzleBinary(puzzle, CORPUSDIR + name + ".e2b");
+  }
+
+  if (openFile(CORPUSDIR "manifest.csv"))
+  { // If the manifest opened, add a line for the puzzle
+    theFile << name << ".e2," << puzzle->size << "," << puzzle->patternNum
+            << "," << puzzle->index << "," << puzzle->seed << ","
+            << (isOfficialStyle ? "Official" : "Random") << std::endl;
+    theFile.close();                     // Close the file after use
+  }
+
+} // outputPuzzle()
+
+
+void FileHandler::writePuzzleText(GeneratedPuzzle* puzzle,       // *In*
+                                  std::string filename)          // *In*
+{ // Writes the pieces of the generated puzzle to a .e2 file, one piece per
+  // line in the same layout as the piece files read in
+
+  // Open the file emptying it of any earlier puzzle of the same name
+  theFile.open(filename.c_str(), std::ios::out | std::ios::trunc);
+
+  if (theFile.is_open())
+  { // If file was opened, output each piece as ID then top, right, bottom and
+    // left pattern
+    for (const std::vector<PuzzlePiece>& pieces : puzzle->pieces)
+    {
+      for (const PuzzlePiece& piece : pieces)
+      {
+        theFile << piece.pieceID << " " << piece.segments[0] << " "
+                << piece.segments[1] << " " << piece.segments[2] << " "
+                << piece.segments[3] << "\n";
+      }
+    }
+
+    theFile.close();         // Close file after use
+  }
+
+} // writePuzzleText()
+
+
+void FileHandler::writePuzzleBinary(GeneratedPuzzle* puzzle,     // *In*
+                                    std::string filename)        // *In*
+{ // Writes the generated puzzle to a binary file. After the four bytes of
+  // CORPUSMAGIC come the size, pattern count, seed and piece count as 32 bit
+  // little endian ints, then each piece as a 32 bit ID followed by one byte
+  // for its type and one byte for each segment, top, right, bottom, left
+
+  int header[4] = { puzzle->size, puzzle->patternNum, (int)puzzle->seed,
+                    puzzle->size * puzzle->size };  // Ints after the magic
+  char bytes[5] = { 0, 0, 0, 0, 0 };               // Type and segments
+
+  // Open the file emptying it of any earlier puzzle of the same name
+  theFile.open(filename.c_str(),
+               std::ios::out | std::ios::trunc | std::ios::binary);
+
+  if (theFile.is_open())
+  { // If file was opened, write the header then every piece
+    theFile.write(CORPUSMAGIC, 4);
+    theFile.write((const char*)header, sizeof(header));
+
+    for (const std::vector<PuzzlePiece>& pieces : puzzle->pieces)
+    {
+      for (const PuzzlePiece& piece : pieces)
+      {
+        bytes[0] = (char)piece.type;
+
+        for (int i = 0; i < 4; i++)
+        {
+          bytes[i + 1] = (char)piece.segments[i];
+        }
+
+        theFile.write((const char*)&piece.pieceID, sizeof(int));
+        theFile.write(bytes, sizeof(bytes));
+      }
+    }
+
+    theFile.close();         // Close file after use
+  }
+
+} // writePuzzleBinary()
+
+
+void FileHandler::writeHeatmap(int genCount)                     // *In*
+{ // Writes the mismatch heatmap to the open file laid out like the board,
+  // each slot showing how many of its edges mismatched across the population
+
+  std::vector<int>* heatmap = boardMan->getHeatmap();  // Mismatches per slot
+
+  theFile << std::endl << "Heatmap generation " << genCount << ":" << std::endl;
+
+  for (int j = 0; j <= boardMan->getSize(); j++)
+  { // Y index for slots to output
+    for (int i = 0; i <= boardMan->getSize(); i++)
+    { // X index for slots to output, add whitespace to separate slots
+      theFile << heatmap->at(i * (boardMan->getSize() + 1) + j) << "  ";
+    }
+
+    theFile << std::endl; // Add whitespace for next row
+  }
+
+} // writeHeatmap()
+
+
 void FileHandler::outputFitness(int genCount,                    // *In*
                                 int fitness)                     // *In*
 { // Appends the fitness to file for tracking of algorithm performance
@@ -302,11 +644,13 @@ void FileHandler::scanFileDirectory()
 void FileHandler::parseInt(int* setting,                         // *Out*
                            std::string label)                    // *In*
 { // Parse int from next line of file placing value in int passed as parameter,
-  // checking label to make sure it is the right setting
+  // checking label to make sure it is the right setting. A line with another
+  // label is left to be read by the next parse
 
   std::string inLine = "/0";         // Stores current line to be parsed
   char inLabel[25] = "/0";           // Stores label of the line from file
   int inputInt = -1;                    // Stores the int that has been read
+  std::streampos lineStart = theFile.tellg();  // Start of the line read
 
   while (std::getline(theFile, inLine))
   { // Read in the next line
@@ -321,9 +665,15 @@ void FileHandler::parseInt(int* setting,                         // *Out*
       { // If the labels match, set the setting to the input
         *setting = inputInt;
       }
+      else
+      { // If the line belongs to a later setting, leave it to be read again
+        theFile.seekg(lineStart);
+      }
 
       break; // Break out of loop
     }
+
+    lineStart = theFile.tellg();     // Next line starts here
   }
 
 } // parseInt()
@@ -332,11 +682,13 @@ void FileHandler::parseInt(int* setting,                         // *Out*
 void FileHandler::parseDouble(double* setting,                   // *Out*
                               std::string label)                 // *In*
 { // Parse double from next line of file placing value in double passed as
-  // parameter, checking the labal to make sure it is the right setting
+  // parameter, checking the labal to make sure it is the right setting. A
+  // line with another label is left to be read by the next parse
 
   std::string inLine = "/0";         // Stores current line to be parsed
   char inLabel[25] = "/0";           // Stores label of the line from file
   double inputDouble = -1;           // Stores the double that has been read
+  std::streampos lineStart = theFile.tellg();  // Start of the line read
 
   while (std::getline(theFile, inLine))
   { // Read in the next line
@@ -351,20 +703,44 @@ void FileHandler::parseDouble(double* setting,                   // *Out*
       { // If the labels match, set the setting to the input
         *setting = inputDouble;
       }
+      else
+      { // If the line belongs to a later setting, leave it to be read again
+        theFile.seekg(lineStart);
+      }
 
       break; // Break out of loop
     }
+
+    lineStart = theFile.tellg();     // Next line starts here
   }
 
 } // parseDouble()
 
 
+void FileHandler::parseOptional(int* setting,                    // *Out*
+                                std::string label,               // *In*
+                                int missing)                     // *In*
+{ // Parse int as parseInt does, but if the label is not found the setting is
+  // given the missing value instead of being left invalid
+
+  *setting = missing;          // Kept if the label is not in the file
+  parseInt(setting, label);    // Replaced by the value if the label is
+
+} // parseOptional()
+
+
 void FileHandler::parseMethods(int inSelect,                     // *In*
                                int inCross,                      // *In*
                                int inMutate,                     // *In*
                                SelectionType* selectType,        // *Out*
                                CrossoverType* crossType,         // *Out*
-                               MutateType* mutType)              // *Out*
+                               MutateType* mutType,              // *Out*
+                               int inRestart,                    // *In*
+                               RestartPolicy* restartType,       // *Out*
+                               int inMode,                       // *In*
+                               GAType* gaType,                   // *Out*
+                               int inSolver,                     // *In*
+                               SolverMode* solverMode)           // *Out*
 { // Parses the methods of selection, crossover and mutation from the int into 
   // the enum values
 
@@ -376,6 +752,10 @@ void FileHandler::parseMethods(int inSelect,                     // *In*
   { // If select method is 1, set select method to tournament
     *selectType = TOURNAMENT;
   }
+  else if (inSelect == 2)
+  { // If select method is 2, set select method to deterministic crowding
+    *selectType = CROWDING;
+  }
 
   if (inCross == 0)
   { // If crossover method is 0, set crossover method to one-point
@@ -406,6 +786,69 @@ void FileHandler::parseMethods(int inSelect,                     // *In*
   { // If mutation method is 0, set mutation method to region rotate
     *mutType = REGIONSWAP;
   }
+  else if (inMutate == 5)
+  { // If mutation method is 5, set mutation method to guided swap
+    *mutType = GUIDEDSWAP;
+  }
+  else if (inMutate == 6)
+  { // If mutation method is 6, set mutation method to region match
+    *mutType = REGIONMATCH;
+  }
+  else if (inMutate == 7)
+  { // If mutation method is 7, set mutation method to adaptive
+    *mutType = ADAPTIVE;
+  }
+
+  if (inRestart == 0)
+  { // If restart policy is 0, set restart policy to full
+    *restartType = FULLRESTART;
+  }
+  else if (inRestart == 1)
+  { // If restart policy is 1, set restart policy to keep elite
+    *restartType = KEEPELITE;
+  }
+  else if (inRestart == 2)
+  { // If restart policy is 2, set restart policy to mutate best
+    *restartType = MUTATEBEST;
+  }
+
+  if (inMode == 0)
+  { // If GA mode is 0, set GA mode to generational
+    *gaType = GENERATIONAL;
+  }
+  else if (inMode == 1)
+  { // If GA mode is 1, set GA mode to steady state replacing the worst
+    *gaType = STEADYWORST;
+  }
+  else if (inMode == 2)
+  { // If GA mode is 2, set GA mode to steady state replacing tournament loser
+    *gaType = STEADYTOURNAMENT;
+  }
+  else if (inMode == 3)
+  { // If GA mode is 3, set GA mode to generational with fused offspring
+    *gaType = FUSED;
+  }
+
+  if (inSolver == 0)
+  { // If solver mode is 0, set solver mode to the GA alone
+    *solverMode = GASOLVER;
+  }
+  else if (inSolver == 1)
+  { // If solver mode is 1, set solver mode to border first
+    *solverMode = BORDERFIRST;
+  }
+  else if (inSolver == 2)
+  { // If solver mode is 2, set solver mode to estimation of distribution
+    *solverMode = EDASOLVER;
+  }
+  else if (inSolver == 3)
+  { // If solver mode is 3, set solver mode to ant colony optimisation
+    *solverMode = ACOSOLVER;
+  }
+  else if (inSolver == 4)
+  { // If solver mode is 4, set solver mode to exhaustive search
+    *solverMode = EXHAUSTIVE;
+  }
 
 } // parseMethods()
 
@@ -478,6 +921,25 @@ void FileHandler::parseData(std::string line,                    // *In*
 } // parseData()
 
 
+void FileHandler::parseHint(std::string line)                    // *In*
+{ // Parses a hint line of the form "H pieceID x y rotation" and locks the
+  // piece in to that slot of every board
+
+  int hint[4] = { -1, -1, -1, -1 };   // Holds the parsed hint data
+
+  if (sscanf_s(line.c_str(), "H %i %i %i %i", &hint[0], &hint[1], &hint[2],
+               &hint[3]) == 4)
+  { // If all four values were read, add the lock to the board manager
+    boardMan->addLock(hint[0], hint[1], hint[2], hint[3]);
+  }
+  else
+  { // Tell the user the hint could not be read
+    std::cout << "Ignoring hint: " << line << std::endl;
+  }
+
+} // parseHint()
+
+
 void FileHandler::createPiece(int parsedData[5])                 // *In*
 { // Creates a new puzzle piece and stores in the puzzle piece vector
 
@@ -494,15 +956,15 @@ void FileHandler::createPiece(int parsedData[5])                 // *In*
 
   if (newPiece.type == CORNER)
   { // If corner, push to corner vector
-    (*BoardManager::getInstance()->getPieces())[CORNER].push_back(newPiece);
+    (*boardMan->getPieces())[CORNER].push_back(newPiece);
   }
   else if (newPiece.type == EDGE)
   { // If edge, push to edge vector
-    (*BoardManager::getInstance()->getPieces())[EDGE].push_back(newPiece);
+    (*boardMan->getPieces())[EDGE].push_back(newPiece);
   }
   else if (newPiece.type == INNER)
   { // If inner, push to inner vector
-    (*BoardManager::getInstance()->getPieces())[INNER].push_back(newPiece);
+    (*boardMan->getPieces())[INNER].push_back(newPiece);
   }
 
 } // createPiece()
@@ -589,14 +1051,14 @@ void FileHandler::outputMatches(Board* theBoard,                 // *In*
   // Ouput how many generations the solution took
   theFile << std::endl << "Generation: " << genCount << std::endl;
 
-  for (int j = 0; j <= BoardManager::getInstance()->getSize(); j++)
+  for (int j = 0; j <= boardMan->getSize(); j++)
   { // Y index for pieces to output
-    for (int i = 0; i <= BoardManager::getInstance()->getSize(); i++)
+    for (int i = 0; i <= boardMan->getSize(); i++)
     { // X index for pieces to ouput, parse a piece into three rows
       // of output.
 
       // Convert pattern ID to char
-      _itoa_s(BoardManager::getInstance()->getPattern(theBoard, i, j, TOP), 
+      _itoa_s(boardMan->getPattern(theBoard, i, j, TOP), 
               buff, 10);
 
       output[0] += "  ";      // Add whitespace for formatting
@@ -604,20 +1066,20 @@ void FileHandler::outputMatches(Board* theBoard,                 // *In*
       output[0] += "  ";      // Add more whitespace for formatting
 
       // Convert pattern ID to char
-      _itoa_s(BoardManager::getInstance()->getPattern(theBoard, i, j, LEFT), 
+      _itoa_s(boardMan->getPattern(theBoard, i, j, LEFT), 
               buff, 10);
 
       output[1] += buff;     // Add converted pattern ID to the middle line
       output[1] += "   ";    // Add whitespace for formatting
 
       // Convert pattern ID to char
-      _itoa_s(BoardManager::getInstance()->getPattern(theBoard, i, j, RIGHT), 
+      _itoa_s(boardMan->getPattern(theBoard, i, j, RIGHT), 
               buff, 10);
 
       output[1] += buff;     // Add right pattern ID to middle line
 
       // Convert pattern ID to char
-      _itoa_s(BoardManager::getInstance()->getPattern(theBoard, i, j, BOTTOM), 
+      _itoa_s(boardMan->getPattern(theBoard, i, j, BOTTOM), 
               buff, 10);
 
       output[2] += "  ";    // Add whitespace for formatting
@@ -644,9 +1106,9 @@ void FileHandler::outputIDs(Board* theBoard,                     // *In*
 
   theFile << std::endl;   // Add whitepsace between two boards
 
-  for (int j = 0; j <= BoardManager::getInstance()->getSize(); j++)
+  for (int j = 0; j <= boardMan->getSize(); j++)
   { // Y index for pieces to output
-    for (int i = 0; i <= BoardManager::getInstance()->getSize(); i++)
+    for (int i = 0; i <= boardMan->getSize(); i++)
     { // X index for pieces to output
 
       // Output piece ID and add comma for separator
@@ -675,6 +1137,10 @@ void FileHandler::appendSelectCross(int select,                  // *In*
   { // If selection method is Tournament, append tournament
     outFilename += " Tournament";
   }
+  else if (select == 2)
+  { // If selection method is Crowding, append crowding
+    outFilename += " Crowding";
+  }
 
   if (crossover == 0)
   { // If crossover method is one point, append one point
@@ -711,6 +1177,18 @@ void FileHandler::appendMutation(int mutation)                   // *In*
   { // If mutation method is region rotate, append region rotate
     outFilename += " RegionRotate";
   }
+  else if (mutation == 5)
+  { // If mutation method is guided swap, append guided swap
+    outFilename += " GuidedSwap";
+  }
+  else if (mutation == 6)
+  { // If mutation method is region match, append region match
+    outFilename += " RegionMatch";
+  }
+  else if (mutation == 7)
+  { // If mutation method is adaptive, append adaptive
+    outFilename += " Adaptive";
+  }
 
 } // appendMutation()
 
@@ -733,7 +1211,7 @@ void FileHandler::makeDataFile(int size,                         // *In*
   filename += ".e2";                         // Append file extension
 
   // Generate a new random board
-  BoardManager::getInstance()->generateBoard(size, pattern);
+  boardMan->generateBoard(size, pattern);
 
   outputDataFile(filename);                 // Output the board to the data file
 
@@ -749,7 +1227,7 @@ void FileHandler::outputDataFile(std::string filename)           // *In*
 
     // Get the address of the piece vectors
     std::vector<std::vector<PuzzlePiece>>* pieceVecs =
-      BoardManager::getInstance()->getPieces();
+      boardMan->getPieces();
 
     for (int i = 0; i <= (int)pieceVecs[CORNER].size(); i++)
     { // Output the various bits of data of the corner pieces to the file
@@ -776,7 +1254,7 @@ void FileHandler::outputDataFile(std::string filename)           // *In*
       theFile << std::endl;  // Move to next line in file
     }
 
-    for (int i = 0; i < (int)(*BoardManager::getInstance()->getPieces())[INNER].
+    for (int i = 0; i < (int)(*boardMan->getPieces())[INNER].
          size(); i++)
     { // Output the various bits of data of the inner pieces to the file
 
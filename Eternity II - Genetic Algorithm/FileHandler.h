@@ -8,19 +8,26 @@
 
 
 #include "BoardManager.h"     // For PieceType, piece vector, board definition
-#include "GeneticAlgorithm.h" // Settings struct
+#include "Settings.h"        // Settings struct
+#include "PuzzleGenerator.h"  // Generated puzzles and corpus settings
 #include <fstream>            // Includes file input and output
 #include <string>             // Includes strings and stoi
 #include <vector>             // Include vectors for filenames
 
 
+#define HINTLABEL 'H'         // First character of a hint line in a e2 file
+#define CORPUSDIR "Corpus/"   // Directory generated puzzles are written to
+#define CORPUSMAGIC "E2PZ"    // First four bytes of a binary puzzle file
+
+
 class FileHandler
 {
 
 private:
   std::fstream theFile;               // File open to read from
   std::vector<std::string> filenames; // Holds all filenames held in directory
-  static std::string outFilename;     // Holds filename of output file
+  std::string outFilename;            // Holds filename of output file
+  BoardManager* boardMan;             // Board manager of the solver
 
   // Opens the file using the filename provided return whether successful
   bool openFile(const char* filename);                // *In*
@@ -30,12 +37,20 @@ private:
   void scanFileDirectory();
  
   // Parse int from next line of file placing value in int passed as parameter,
-  // checking label to make sure it is the right setting
+  // checking label to make sure it is the right setting. A line with another
+  // label is left to be read by the next parse
   void parseInt(int* setting,                         // *Out*
                 std::string label);                   // *In*
 
+  // Parse int as parseInt does, but if the label is not found the setting is
+  // given the missing value instead of being left invalid
+  void parseOptional(int* setting,                    // *Out*
+                     std::string label,               // *In*
+                     int missing);                    // *In*
+
   // Parse double from next line of file placing value in double passed as
-  // parameter, checking the labal to make sure it is the right setting
+  // parameter, checking the labal to make sure it is the right setting. A
+  // line with another label is left to be read by the next parse
   void parseDouble(double* setting,                   // *Out*
                    std::string label);                // *In* 
 
@@ -46,7 +61,13 @@ private:
                     int inMutate,                     // *In*
                     SelectionType* selectType,        // *Out*
                     CrossoverType* crossType,         // *Out*
-                    MutateType* mutType);             // *Out*       
+                    MutateType* mutType,              // *Out*
+                    int inRestart,                    // *In*
+                    RestartPolicy* restartType,       // *Out*
+                    int inMode,                       // *In*
+                    GAType* gaType,                   // *Out*
+                    int inSolver,                     // *In*
+                    SolverMode* solverMode);          // *Out*
 
   // Find the correct filename from the vector of puzzle file names found
   // during the directory scan
@@ -58,6 +79,10 @@ private:
   void parseData(std::string inLine,                  // *In*
                  int parsedData[5]);                  // *Out*
 
+  // Parses a hint line of the form "H pieceID x y rotation" and locks the
+  // piece in to that slot of every board
+  void parseHint(std::string line);                   // *In*
+
   // Creates a new puzzle piece and stores in the puzzle piece vector
   void createPiece(int parsedData[5]);                // *In*
 
@@ -82,6 +107,10 @@ private:
   void outputIDs(Board* theBoard,                     // *In*
                  int genCount);                       // *In*
 
+  // Writes the mismatch heatmap to the open file laid out like the board,
+  // each slot showing how many of its edges mismatched across the population
+  void writeHeatmap(int genCount);                    // *In*
+
   // Append the selection method and crossover method to filename
   void appendSelectCross(int select,                  // *In*
                          int crossover);              // *In*
@@ -98,6 +127,21 @@ private:
   // line
   void outputDataFile(std::string filename);          // *In*
 
+  // Writes the pieces of the generated puzzle to a .e2 file, one piece per
+  // line in the same layout as the piece files read in
+  void writePuzzleText(GeneratedPuzzle* puzzle,       // *In*
+                       std::string filename);         // *In*
+
+  // Writes the generated puzzle to a binary file. After the four bytes of
+  // CORPUSMAGIC come the size, pattern count, seed and piece count as 32 bit
+  // little endian ints, then each piece as a 32 bit ID followed by one byte
+  // for its type and one byte for each segment, top, right, bottom, left
+  void writePuzzleBinary(GeneratedPuzzle* puzzle,     // *In*
+                         std::string filename);       // *In*
+
+  // Checks all of the generator settings that have been read in are valid
+  bool CheckGenerator(GeneratorSettings* corpus);     // *In*
+
   // Checks all of the input that has been read in make sure they are valid
   // inputs
   bool CheckInput(int inSize,                         // *In*         
@@ -108,23 +152,28 @@ private:
                   int inMutMethod,                    // *In*
                   double inMutRate,                   // *In*
                   int inElite,                        // *In*
-                  int startPiece);                    // *In*
+                  int startPiece,                     // *In*
+                  int inRestart,                      // *In*
+                  int inMode,                         // *In*
+                  int inTournament,                   // *In*
+                  int inSolver,                       // *In*
+                  int inBatch,                        // *In*
+                  int inBias,                         // *In*
+                  int inSolutions,                    // *In*
+                  int inGenerator,                    // *In*
+                  int inTime,                         // *In*
+                  int inGenLimit,                     // *In*
+                  int inEvalLimit,                    // *In*
+                  int inTarget);                      // *In*
 
 public:
-  // Calls to scan the directory for piece data files
-  FileHandler();
+  // Calls to scan the directory for piece data files, pieces read are stored
+  // in the board manager of the solver given
+  FileHandler(BoardManager* manager);                 // *In*
 
   // Reads the settings file named "settings.ini" in the root directory, 
   // setting the appropriate values that have been read in to the algorithm
-  void readSettingsFile(int* boardSize,               // *Out*
-                        int* patternNum,              // *Out*
-                        int* popSize,                 // *Out*
-                        SelectionType* selectMethod,  // *Out*
-                        CrossoverType* crossMethod,   // *Out*
-                        MutateType* mutMethod,        // *Out*
-                        double* mutRate,              // *Out*
-                        int* eliteRate,               // *Out*
-                        bool* isStartPiece,           // *Out*
+  void readSettingsFile(Settings* settings,           // *Out*
                         bool* isSuccess);             // *Out*
 
   // Reads the piece file with the file name that matches the information passed
@@ -137,6 +186,25 @@ public:
   void outputBoard(Board* theBoard,                   // *In* 
                    int genCount);                     // *In*
 
+  // Appends the mismatch heatmap of the generation to the output file
+  void outputHeatmap(int genCount);                   // *In*
+
+  // Reads the generator file named "generator.ini" in the root directory,
+  // success is set to false if the file is missing or a setting is not valid
+  void readGeneratorFile(GeneratorSettings* corpus,   // *Out*
+                         bool* isSuccess);            // *Out*
+
+  // Makes the corpus directory and starts a new manifest, replacing any
+  // manifest left by an earlier corpus
+  void startCorpus();
+
+  // Writes the generated puzzle to a .e2 file in the corpus directory, and to
+  // a .e2b binary file as well if binary is on, then adds a line for it to
+  // the manifest so the puzzle can be made again from its seed
+  void outputPuzzle(GeneratedPuzzle* puzzle,          // *In*
+                    bool isOfficialStyle,             // *In*
+                    bool isBinary);                   // *In*
+
   // Calculate the output filename
   void outputFitness(int genCount,                    // *In*
                      int fitness);                    // *In*
@@ -0,0 +1,62 @@
+// Title        : FitnessCache.cpp
+// Purpose      : Remembers the fitness of boards by Zobrist hash
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#include "FitnessCache.h"       // Class declaration
+
+
+FitnessCache::FitnessCache() : table(CACHESIZE)
+{ // Creates the empty table of entries and zeros the counters
+
+  for (int i = 0; i < CACHESIZE; i++)
+  { // Atomics are not zeroed when created so clear every entry
+    table[i].key.store(0);
+    table[i].data.store(0);
+  }
+
+  hits.store(0);            // No lookups yet
+  misses.store(0);          // No lookups yet
+
+} // FitnessCache()
+
+
+bool FitnessCache::lookup(Board* theBoard)                    // *In-Out*
+{ // Looks up the board by its hash, if found sets the fitness score and match
+  // count of the board and returns true
+
+  CacheEntry* entry = &table[theBoard->hash & (CACHESIZE - 1)];
+  unsigned long long key = entry->key.load(std::memory_order_relaxed);
+  unsigned long long data = entry->data.load(std::memory_order_relaxed);
+
+  if ((key ^ data) != theBoard->hash || data == 0)
+  { // If the entry holds a different board, half written or empty, miss
+    misses++;
+    return false;
+  }
+
+  // Fitness score is held in the high half and match count in the low half
+  theBoard->fitScore = (int)(data >> 32);
+  theBoard->matchCount = (int)(data & 0xFFFFFFFFull);
+
+  hits++;
+  return true;
+
+} // lookup()
+
+
+void FitnessCache::store(Board* theBoard)                     // *In*
+{ // Stores the fitness score and match count of the board under its hash,
+  // replacing whatever was in the entry before
+
+  CacheEntry* entry = &table[theBoard->hash & (CACHESIZE - 1)];
+
+  // Pack fitness score in to the high half and match count in to the low half
+  unsigned long long data = ((unsigned long long)theBoard->fitScore << 32) |
+                            (unsigned int)theBoard->matchCount;
+
+  entry->key.store(theBoard->hash ^ data, std::memory_order_relaxed);
+  entry->data.store(data, std::memory_order_relaxed);
+
+} // store()
\ No newline at end of file
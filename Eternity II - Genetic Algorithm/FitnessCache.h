@@ -0,0 +1,61 @@
+// Title        : FitnessCache.h
+// Purpose      : Remembers the fitness of boards by Zobrist hash
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#define CACHESIZE 65536         // Entries in the cache (power of two)
+
+
+#include "BoardManager.h"       // Board definition
+#include <atomic>               // Lock free entries and counters
+#include <vector>               // Table of entries
+
+
+struct CacheEntry
+{ // Holds one cached fitness. The key is stored XORed with the data so a
+  // torn write from another thread fails the key check instead of giving
+  // the wrong fitness for a board
+
+  std::atomic<unsigned long long> key;   // Board hash XOR data
+  std::atomic<unsigned long long> data;  // Fitness score and match count
+
+}; // CacheEntry
+
+
+class FitnessCache
+{
+
+private:
+  std::vector<CacheEntry> table;                  // Direct mapped entries
+  std::atomic<long long> hits;                    // Lookups found in cache
+  std::atomic<long long> misses;                  // Lookups not in cache
+
+public:
+  // Creates the empty table of entries and zeros the counters
+  FitnessCache();
+
+  // Looks up the board by its hash, if found sets the fitness score and match
+  // count of the board and returns true
+  bool lookup(Board* theBoard);                   // *In-Out*
+
+  // Stores the fitness score and match count of the board under its hash,
+  // replacing whatever was in the entry before
+  void store(Board* theBoard);                    // *In*
+
+  // Returns how many lookups were found in the cache
+  inline long long getHits()
+  {
+    return hits.load();     // Return count of hits
+  } // getHits()
+
+  // Returns how many lookups were not found in the cache
+  inline long long getMisses()
+  {
+    return misses.load();   // Return count of misses
+  } // getMisses()
+
+}; // FitnessCache
\ No newline at end of file
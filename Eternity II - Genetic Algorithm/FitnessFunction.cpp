@@ -7,17 +7,134 @@
 #include "FitnessFunction.h"    // Class declaration
 
 
-FitnessFunction::FitnessFunction()
-{ // Initialse board and board manager pointers
+// Returns whether the slot is a corner of a board with the last index given
+constexpr bool isCornerSlot(int xIndex, int yIndex, int last)
+{
+  return (xIndex == 0 || xIndex == last) && (yIndex == 0 || yIndex == last);
+} // isCornerSlot()
+
+
+// Returns whether the slot is on the border of a board with the last index
+// given
+constexpr bool isBorderSlot(int xIndex, int yIndex, int last)
+{
+  return xIndex == 0 || yIndex == 0 || xIndex == last || yIndex == last;
+} // isBorderSlot()
+
+
+// Returns the points a match between the two adjacent slots is worth, the
+// same weights as getEdgeWeight but worked out at compile time
+constexpr int edgeWeight(int xIndex1, int yIndex1, int xIndex2, int yIndex2,
+                         int last)
+{
+  return (isCornerSlot(xIndex1, yIndex1, last) ||
+          isCornerSlot(xIndex2, yIndex2, last)) ? CORNERMATCH :
+         (isBorderSlot(xIndex1, yIndex1, last) ||
+          isBorderSlot(xIndex2, yIndex2, last)) ? EDGEMATCH : INNERMATCH;
+} // edgeWeight()
+
+
+FitnessFunction::FitnessFunction(BoardManager* manager)  // *In*
+{ // Initialse board pointer and the board manager of the solver
 
   theBoard = nullptr;                       // Init pointer to board to null
-  boardMan = BoardManager::getInstance();   // Get the instance of board manager
+  boardMan = manager;                       // Board manager of the solver
 
 } // FitnessFunction()
 
 
+template <int SIZE>
+void FitnessFunction::checkSized(Board* aBoard)          // *In-Out*
+{ // Checks the fitness of a board with SIZE slots per side. The size is known
+  // at compile time so the loops can be unrolled and the edge weights folded
+
+  const int last = SIZE - 1;          // Last index of the board
+  int score = 0;                      // Holds the score of the board
+  int matches = 0;                    // Holds the pattern matches of the board
+  int isMatch = 0;                    // Whether the current edge matches
+
+  // Whether the border is locked, the edges between border slots are then
+  // the same in every board and their stored score is used instead
+  const bool isRingFixed = boardMan->getRingScore() >= 0;
+
+  if (isRingFixed)
+  { // Start from the score of the locked ring
+    score = boardMan->getRingScore();
+    matches = boardMan->getRingMatches();
+  }
+
+  // Pattern showing on each side of every slot once the piece is rotated
+  int colours[SIZE][SIZE][4];
+
+  for (int i = 0; i < SIZE; i++)
+  { // Look up each piece once, storing the patterns it shows on each side
+    const PackedPiece* column = aBoard->boardVecs[i].data();
+
+    for (int j = 0; j < SIZE; j++)
+    {
+      for (int side = TOP; side <= LEFT; side++)
+      {
+        colours[i][j][side] = boardMan->getSegment(column[j].pieceID,
+                                                   column[j].orientation,
+                                                   side);
+      }
+    }
+  }
+
+  for (int i = 0; i < SIZE; i++)
+  { // X index of slots
+    for (int j = 0; j < SIZE; j++)
+    { // Y index of slots, checking the edges to the right and below
+
+      if (i < last && !(isRingFixed && (j == 0 || j == last)))
+      { // Compare the right of the slot with the left of the slot to the right
+        isMatch = (colours[i][j][RIGHT] == colours[i + 1][j][LEFT]);
+        score += isMatch * edgeWeight(i, j, i + 1, j, last);
+        matches += isMatch;
+      }
+
+      if (j < last && !(isRingFixed && (i == 0 || i == last)))
+      { // Compare the bottom of the slot with the top of the slot below
+        isMatch = (colours[i][j][BOTTOM] == colours[i][j + 1][TOP]);
+        score += isMatch * edgeWeight(i, j, i, j + 1, last);
+        matches += isMatch;
+      }
+    }
+  }
+
+  aBoard->fitScore = score;           // Store the score of the board
+  aBoard->matchCount = matches;       // Store the matches of the board
+
+} // checkSized()
+
+
 void FitnessFunction::checkFitness(Board* aBoard)        // *In-Out*
-{ // Checks the fitness of the candidate provided by the GA
+{ // Checks the fitness of the candidate provided by the GA, using the check
+  // specialised for the board size if there is one
+
+  boardMan->addChecks(1);   // Count the check against the evaluation budget
+
+  switch (boardMan->getSize() + 1)
+  { // Board size is per solver so the check is chosen for each board
+    case 4:     // Smallest test board
+      checkSized<4>(aBoard);
+      return;
+
+    case 8:     // Test board
+      checkSized<8>(aBoard);
+      return;
+
+    case 10:    // Test board
+      checkSized<10>(aBoard);
+      return;
+
+    case 16:    // Official Eternity II board
+      checkSized<16>(aBoard);
+      return;
+
+    default:    // Use the general checks below
+      break;
+  }
 
   theBoard = aBoard;        // Defines the board pointer to the current board
   theBoard->fitScore = 0;   // Sets the score to 0 to begin calculation
@@ -39,6 +156,313 @@ void FitnessFunction::checkFitness(Board* aBoard)        // *In-Out*
 } // checkFitness()
 
 
+void FitnessFunction::checkBatch(std::vector<Board>* population, // *In-Out*
+                                 const std::vector<int>& indexes) // *In*
+{ // Checks the fitness of the boards of the population at the indexes given.
+  // Boards are loaded BATCHSIZE at a time so each edge is compared across the
+  // whole batch in one loop, which the compiler turns in to vector compares
+
+  int slotCount = (boardMan->getSize() + 1) * (boardMan->getSize() + 1);
+  int laneCount = 0;                // Boards loaded in to the current batch
+  int scores[BATCHSIZE];            // Score of each board of the batch
+  int matches[BATCHSIZE];           // Matches of each board of the batch
+
+  // Whether the border is locked, the ring score is then added to every board
+  const bool isRingFixed = boardMan->getRingScore() >= 0;
+
+  boardMan->addChecks((int)indexes.size());  // Count the batch checks
+  buildBatchEdges();                // Ring may have been locked since last
+  batchColours.resize(slotCount * 4 * BATCHSIZE);
+
+  for (int first = 0; first < (int)indexes.size(); first += BATCHSIZE)
+  { // Check the boards one batch at a time
+
+    laneCount = (int)indexes.size() - first;
+    laneCount = (laneCount < BATCHSIZE) ? laneCount : BATCHSIZE;
+
+    for (int lane = 0; lane < laneCount; lane++)
+    { // Load the patterns of each board of the batch in to its lane
+      loadBatchLane(&population->at(indexes[first + lane]), lane);
+    }
+
+    for (int lane = 0; lane < BATCHSIZE; lane++)
+    { // Start each board from the ring score if the border is locked
+      scores[lane] = isRingFixed ? boardMan->getRingScore() : 0;
+      matches[lane] = isRingFixed ? boardMan->getRingMatches() : 0;
+    }
+
+    for (const BatchEdge& edge : batchEdges)
+    { // Compare the edge across every lane of the batch. Lanes past the
+      // boards loaded hold old patterns and their results are not used
+
+      const unsigned char* colours1 =
+        &batchColours[(edge.slot1 * 4 + edge.side1) * BATCHSIZE];
+      const unsigned char* colours2 =
+        &batchColours[(edge.slot2 * 4 + edge.side2) * BATCHSIZE];
+
+      for (int lane = 0; lane < BATCHSIZE; lane++)
+      {
+        int isMatch = (colours1[lane] == colours2[lane]);
+        scores[lane] += isMatch * edge.weight;
+        matches[lane] += isMatch;
+      }
+    }
+
+    for (int lane = 0; lane < laneCount; lane++)
+    { // Store the results back in to the boards of the batch
+      population->at(indexes[first + lane]).fitScore = scores[lane];
+      population->at(indexes[first + lane]).matchCount = matches[lane];
+    }
+  }
+
+} // checkBatch()
+
+
+void FitnessFunction::buildBatchEdges()
+{ // Builds the list of edges for the batch check. Edges between two border
+  // slots are left out once the ring is locked, as for the sized checks
+
+  int size = boardMan->getSize();   // Last index of the board
+  bool isRingFixed = boardMan->getRingScore() >= 0;
+
+  // Whether each slot is on the border of the board
+  bool isBorder1 = false;
+  bool isBorder2 = false;
+
+  batchEdges.clear();
+
+  for (int i = 0; i <= size; i++)
+  { // X index of slots
+    for (int j = 0; j <= size; j++)
+    { // Y index of slots, adding the edges to the right and below
+
+      isBorder1 = (i == 0 || j == 0 || i == size || j == size);
+
+      if (i < size)
+      { // Right of the slot against the left of the slot to the right
+        isBorder2 = (i + 1 == size || j == 0 || j == size);
+
+        if (!(isRingFixed && isBorder1 && isBorder2))
+        {
+          batchEdges.push_back({ i * (size + 1) + j, RIGHT,
+                                 (i + 1) * (size + 1) + j, LEFT,
+                                 getEdgeWeight(i, j, i + 1, j) });
+        }
+      }
+
+      if (j < size)
+      { // Bottom of the slot against the top of the slot below
+        isBorder2 = (i == 0 || i == size || j + 1 == size);
+
+        if (!(isRingFixed && isBorder1 && isBorder2))
+        {
+          batchEdges.push_back({ i * (size + 1) + j, BOTTOM,
+                                 i * (size + 1) + j + 1, TOP,
+                                 getEdgeWeight(i, j, i, j + 1) });
+        }
+      }
+    }
+  }
+
+} // buildBatchEdges()
+
+
+void FitnessFunction::loadBatchLane(Board* aBoard,       // *In*
+                                    int lane)            // *In*
+{ // Copies the patterns showing on each side of every slot of the board in to
+  // the lane given of the batch colours. Pattern IDs are below the number of
+  // patterns on the board so each fits in one byte
+
+  int size = boardMan->getSize();   // Last index of the board
+  int slot = 0;                     // Index of the slot being loaded
+
+  for (int i = 0; i <= size; i++)
+  { // X index of slots
+    const PackedPiece* column = aBoard->boardVecs[i].data();
+
+    for (int j = 0; j <= size; j++, slot++)
+    {
+      for (int side = TOP; side <= LEFT; side++)
+      {
+        batchColours[(slot * 4 + side) * BATCHSIZE + lane] =
+          (unsigned char)boardMan->getSegment(column[j].pieceID,
+                                              column[j].orientation, side);
+      }
+    }
+  }
+
+} // loadBatchLane()
+
+
+int FitnessFunction::checkLocal(Board* aBoard,           // *In*
+                                int slots[][2],          // *In*
+                                int slotCount,           // *In*
+                                int* matches)            // *Out*
+{ // Scores only the edges touching the slots given, counting each edge once.
+  // Used to work out the change in fitness of a move without a full check
+
+  int score = 0;              // Holds the score of the edges checked
+  int xIndex = -1;            // X index of the neighbouring slot
+  int yIndex = -1;            // Y index of the neighbouring slot
+  bool isCounted = false;     // Whether edge was scored by an earlier slot
+
+  // Offsets to the slots above, to the right, below and to the left
+  const int offsets[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+
+  theBoard = aBoard;          // Defines the board pointer to the board given
+  *matches = 0;               // Sets the matches to 0 to begin calculation
+
+  for (int i = 0; i < slotCount; i++)
+  { // Loop through each slot checking the edge to each neighbour
+
+    for (int side = TOP; side <= LEFT; side++)
+    { // Check the neighbour on each side of the slot
+
+      xIndex = slots[i][0] + offsets[side][0];
+      yIndex = slots[i][1] + offsets[side][1];
+
+      if (xIndex < 0 || yIndex < 0 || xIndex > boardMan->getSize() ||
+          yIndex > boardMan->getSize())
+      { // If the side faces the edge of the board there is nothing to match
+        continue;
+      }
+
+      isCounted = false;
+
+      for (int j = 0; j < i; j++)
+      { // If the neighbour is an earlier slot in the list, the edge has
+        // already been scored
+        if (slots[j][0] == xIndex && slots[j][1] == yIndex)
+        {
+          isCounted = true;
+        }
+      }
+
+      if (!isCounted && boardMan->getPattern(theBoard, slots[i][0],
+          slots[i][1], (segLocation)side) == boardMan->getPattern(theBoard,
+          xIndex, yIndex, (segLocation)((side + 2) % 4)))
+      { // If the patterns on both sides of the edge match, add score
+        score += getEdgeWeight(slots[i][0], slots[i][1], xIndex, yIndex);
+        (*matches)++;
+      }
+    } // for side <= LEFT
+  } // for i < slotCount
+
+  return score;               // Return the score of the edges
+
+} // checkLocal()
+
+
+void FitnessFunction::fixRing(Board* aBoard)             // *In*
+{ // Scores the edges between border slots of the board given and stores them
+  // in the board manager. Once the whole border is locked every board has the
+  // same ring, so the sized checks skip those edges and add the stored score
+
+  int size = boardMan->getSize();   // Last index of the board
+  int score = 0;                    // Holds the score of the ring
+  int matches = 0;                  // Holds the matches of the ring
+
+  theBoard = aBoard;                // Defines the board pointer to the board
+
+  for (int i = 0; i < size; i++)
+  { // Edges along the top and bottom rows, then the left and right columns
+
+    if (isMatchSide(i, 0, i + 1, 0))
+    { // Top row
+      score += getEdgeWeight(i, 0, i + 1, 0);
+      matches++;
+    }
+
+    if (isMatchSide(i, size, i + 1, size))
+    { // Bottom row
+      score += getEdgeWeight(i, size, i + 1, size);
+      matches++;
+    }
+
+    if (isMatchBottom(0, i, 0, i + 1))
+    { // Left column
+      score += getEdgeWeight(0, i, 0, i + 1);
+      matches++;
+    }
+
+    if (isMatchBottom(size, i, size, i + 1))
+    { // Right column
+      score += getEdgeWeight(size, i, size, i + 1);
+      matches++;
+    }
+  }
+
+  boardMan->setRing(score, matches);  // Store for the sized checks
+
+} // fixRing()
+
+
+void FitnessFunction::addMismatches(Board* aBoard)       // *In*
+{ // Adds the mismatched edges of the board given to the heatmap of the board
+  // manager, counting each mismatched edge against both of its slots
+
+  int size = boardMan->getSize();                   // Last index of the board
+  std::vector<int>* heatmap = boardMan->getHeatmap(); // Mismatches per slot
+
+  theBoard = aBoard;        // Defines the board pointer to the board given
+
+  for (int i = 0; i <= size; i++)
+  { // X index of slots
+    for (int j = 0; j <= size; j++)
+    { // Y index of slots, checking the edges to the right and below
+
+      if (i < size && !isMatchSide(i, j, i + 1, j))
+      { // Right of the slot does not match the slot to the right
+        heatmap->at(i * (size + 1) + j)++;
+        heatmap->at((i + 1) * (size + 1) + j)++;
+      }
+
+      if (j < size && !isMatchBottom(i, j, i, j + 1))
+      { // Bottom of the slot does not match the slot below
+        heatmap->at(i * (size + 1) + j)++;
+        heatmap->at(i * (size + 1) + j + 1)++;
+      }
+    }
+  }
+
+} // addMismatches()
+
+
+int FitnessFunction::getEdgeWeight(int xIndex1,          // *In*
+                                   int yIndex1,          // *In*
+                                   int xIndex2,          // *In*
+                                   int yIndex2)          // *In*
+{ // Returns how many points a match between the two adjacent slots is worth,
+  // corner if either slot is a corner, edge if either slot is on the border
+
+  int size = boardMan->getSize();   // Last index of the board
+  int weight = INNERMATCH;          // Holds the weight of the edge
+
+  // Work out if either slot is on the border of the board
+  bool isBorder1 = (xIndex1 == 0 || yIndex1 == 0 || xIndex1 == size ||
+                    yIndex1 == size);
+  bool isBorder2 = (xIndex2 == 0 || yIndex2 == 0 || xIndex2 == size ||
+                    yIndex2 == size);
+
+  if ((xIndex1 == 0 || xIndex1 == size) && (yIndex1 == 0 || yIndex1 == size))
+  { // If first slot is a corner, use corner weight
+    weight = CORNERMATCH;
+  }
+  else if ((xIndex2 == 0 || xIndex2 == size) && 
+           (yIndex2 == 0 || yIndex2 == size))
+  { // If second slot is a corner, use corner weight
+    weight = CORNERMATCH;
+  }
+  else if (isBorder1 || isBorder2)
+  { // If either slot is on the border, use edge weight
+    weight = EDGEMATCH;
+  }
+
+  return weight;                    // Return the weight of the edge
+
+} // getEdgeWeight()
+
+
 bool FitnessFunction::isMatchSide(int xIndex1,             // *In*
                                   int yIndex1,             // *In*
                                   int xIndex2,             // *In*
@@ -10,9 +10,25 @@
 #define CORNERMATCH 10          // How many points for corner match
 #define EDGEMATCH   5           // How many points for edge match
 #define INNERMATCH  1           // How many points for inner match
+#define BATCHSIZE   64          // Boards checked side by side in a batch
 
 
 #include "BoardManager.h"       // For board size access, board definition
+#include <vector>               // Batch colours and edges
+
+
+struct BatchEdge
+{ // Holds one edge between two adjacent slots for the batch check, the slots
+  // as indexes of x * (size + 1) + y, the side of each slot facing the other
+  // and the points a match is worth
+
+  int slot1;        // Slot on the left or above
+  int side1;        // Side of first slot facing the second
+  int slot2;        // Slot on the right or below
+  int side2;        // Side of second slot facing the first
+  int weight;       // Points for a match on this edge
+
+}; // BatchEdge
 
 
 class FitnessFunction
@@ -22,6 +38,25 @@ private:
   Board* theBoard;                      // Holds pointer to current board
   BoardManager* boardMan;              // For access to board size
 
+  // Pattern on each side of each slot for every board of a batch, stored so
+  // the same slot and side of all the boards in the batch sit side by side
+  std::vector<unsigned char> batchColours;
+  std::vector<BatchEdge> batchEdges;   // Edges scored by the batch check
+
+  // Checks the fitness of a board with SIZE slots per side. The size is known
+  // at compile time so the loops can be unrolled and the edge weights folded
+  template <int SIZE>
+  void checkSized(Board* aBoard);                         // *In-Out*
+
+  // Builds the list of edges for the batch check. Edges between two border
+  // slots are left out once the ring is locked, as for the sized checks
+  void buildBatchEdges();
+
+  // Copies the patterns showing on each side of every slot of the board in to
+  // the lane given of the batch colours
+  void loadBatchLane(Board* aBoard,                       // *In*
+                     int lane);                           // *In*
+
   // Checks to see if the pattern located on right side of piece1 matches the
   // pattern located on the left of piece2
   bool isMatchSide(int xIndex1,         // *In*
@@ -76,11 +111,41 @@ private:
   void checkInnerPieces();
 
 public:
-  // Initialse board and board manager pointers
-  FitnessFunction();
+  // Initialse board pointer and the board manager of the solver
+  FitnessFunction(BoardManager* manager);   // *In*
 
-  // Checks the fitness of the candidate provided by the GA
+  // Checks the fitness of the candidate provided by the GA, using the check
+  // specialised for the board size if there is one
   void checkFitness(Board* theBoard);   // *In-Out*
 
+  // Checks the fitness of the boards of the population at the indexes given.
+  // Boards are loaded BATCHSIZE at a time so each edge is compared across the
+  // whole batch in one loop, which the compiler turns in to vector compares
+  void checkBatch(std::vector<Board>* population,         // *In-Out*
+                  const std::vector<int>& indexes);       // *In*
+
+  // Scores only the edges touching the slots given, counting each edge once.
+  // Used to work out the change in fitness of a move without a full check
+  int checkLocal(Board* aBoard,         // *In*
+                 int slots[][2],        // *In*
+                 int slotCount,         // *In*
+                 int* matches);         // *Out*
+
+  // Scores the edges between border slots of the board given and stores them
+  // in the board manager. Once the whole border is locked every board has the
+  // same ring, so the sized checks skip those edges and add the stored score
+  void fixRing(Board* aBoard);          // *In*
+
+  // Adds the mismatched edges of the board given to the heatmap of the board
+  // manager, counting each mismatched edge against both of its slots
+  void addMismatches(Board* aBoard);    // *In*
+
+  // Returns how many points a match between the two adjacent slots is worth,
+  // corner if either slot is a corner, edge if either slot is on the border
+  int getEdgeWeight(int xIndex1,        // *In*
+                    int yIndex1,        // *In*
+                    int xIndex2,        // *In*
+                    int yIndex2);       // *In*
+
 }; // FitnessFunction
 
@@ -5,10 +5,30 @@
 
 
 #include "GeneticAlgorithm.h"  // Class declaration
-#include "FileHandler.h"       // File input and output
 #include <algorithm>           // Sorting
+#include <chrono>              // Timing generated corpora and time limit
 #include <iostream>            // Console output
 #include <limits>              // Ignore all chars on input
+#include <unordered_set>       // Counting distinct boards
+
+
+// Nothing has asked the run to stop until a signal arrives
+volatile std::sig_atomic_t GeneticAlgorithm::isStopRequested = 0;
+
+
+GeneticAlgorithm::GeneticAlgorithm() : theFile(&boardMan),
+                                       theCrossover(&boardMan),
+                                       theMutation(&boardMan),
+                                       theFitness(&boardMan),
+                                       theTabu(&boardMan),
+                                       theBorder(&boardMan),
+                                       theEDA(&boardMan),
+                                       theACO(&boardMan),
+                                       theExhaustive(&boardMan)
+{ // Creates the board manager of the solver and hands it to every object that
+  // works on the pieces or populations, so solvers do not share any state
+
+} // GeneticAlgorithm()
 
 
 void GeneticAlgorithm::setup(bool* isSuccess)           // *Out*
@@ -16,42 +36,70 @@ void GeneticAlgorithm::setup(bool* isSuccess)           // *Out*
   // with the size of the population for each generation. Also handles crossover 
   // and mutation methods
 
-  FileHandler inputFile;                         // File handler to do input
-  int boardSize = -1;                            // Holds input board size   
-  int patternNum = -1;                           // Holds input pattern num
-  int eliteRate = -1;                            // Holds input elitism rate
-  double mutRate = -1;                           // Holds input mutation rate
   bool inputSuccess = true;                      // Holds if input was success
-  SelectionType selectMethod = SELECTDEFAULT;    // Holds input input select
-  CrossoverType crossMethod = CROSSDEFAULT;      // Holds input crossover method
-  MutateType mutMethod = MUTDEFAULT;             // Holds input mutation method
+
+  settings.boardSize = -1;                       // Holds input board size
+  settings.patternNum = -1;                      // Holds input pattern num
+  settings.popSize = -1;                         // Holds input population size
+  settings.selectMethod = SELECTDEFAULT;         // Holds input input select
+  settings.crossMethod = CROSSDEFAULT;           // Holds input crossover method
+  settings.mutMethod = MUTDEFAULT;               // Holds input mutation method
+  settings.mutRate = -1;                         // Holds input mutation rate
+  settings.eliteRate = -1;                       // Holds input elitism rate
+  settings.tournamentSize = TOURNAMENTDEFAULT;   // Init tournament size
+  settings.isStartPiece = false;                 // Holds input start piece
+  settings.restartMethod = FULLRESTART;          // Init restart policy default
+  settings.gaMode = GENERATIONAL;                // Init GA mode to default
+  settings.solverMode = GASOLVER;                // Init solver mode to default
+  settings.isBatchFitness = false;               // Init batch checks to off
+  settings.isMismatchBias = false;               // Init mismatch bias to off
+  settings.solutionCount = 1;                    // Init to stop at first solve
+  settings.isGenerator = false;                  // Init generator to off
+  settings.timeLimit = 0;                        // Init to no time limit
+  settings.generationLimit = 0;                  // Init to no generation limit
+  settings.evaluationLimit = 0;                  // Init to no evaluation limit
+  settings.targetMatch = 100;                    // Init to stop when solved
 
   maxFitness = 0;                // Initialise maximum fitness of 100% candidate
   currFitness = 0;               // Init maximum fitness GA has reached
   genCount = 0;                  // Init generation count
+  uniqueCount = 0;               // Init count of distinct boards
+  isScored = false;              // Init population as not yet scored
+  bestFitness = -1;              // Init so the first board checked is best
+  bestGen = 0;                   // Init generation of the best board
   maxMatches = 0;                // Init maximum matches in candidate
 
-  // Get the input from the settings file, storing in appropriate variables
-  inputFile.readSettingsFile(&boardSize, &patternNum, &popSize, &selectMethod,
-                             &crossMethod, &mutMethod, &mutRate, &eliteRate,
-                             &isStartPiece, &inputSuccess);
+  // Get the input from the settings file, storing in the settings
+  theFile.readSettingsFile(&settings, &inputSuccess);
 
   if (inputSuccess == true)
   { // Set up the crossover object using the input methods
-    theCrossover.setMethod(crossMethod, selectMethod, eliteRate);
+    theCrossover.setMethod(settings.crossMethod, settings.selectMethod,
+                           settings.eliteRate, settings.tournamentSize);
 
     // Set up the mutation method using the input methods
-    theMutation.setup(mutMethod, mutRate, popSize);
+    theMutation.setup(settings.mutMethod, settings.mutRate, settings.popSize);
 
     // Output all settings to user
-    outputSettings(boardSize, patternNum, popSize, selectMethod,
-                   crossMethod, mutMethod, mutRate, eliteRate);
+    outputSettings(settings.boardSize, settings.patternNum, settings.popSize,
+                   settings.selectMethod, settings.crossMethod,
+                   settings.mutMethod, settings.mutRate, settings.eliteRate,
+                   settings.tournamentSize, settings.restartMethod,
+                   settings.gaMode, settings.solverMode);
 
     // Calculate the maximum fitness of a 100% solved candidate
-    calcMaxFitness(boardSize);
+    calcMaxFitness(settings.boardSize);
 
     // Initialise the board manager with the board size and number of patterns
-    BoardManager::getInstance()->initialiseData(boardSize, patternNum);
+    boardMan.initialiseData(settings.boardSize, settings.patternNum);
+
+    if (settings.isStartPiece)
+    { // If the start constraint is active, lock the start piece in its slot
+      boardMan.lockStartPiece();
+    }
+
+    // Fix the start piece and any hint pieces from the puzzle file in place
+    boardMan.buildLocks();
   }
   else
   { // Check if user wants to continue with application defaults
@@ -61,22 +109,22 @@ void GeneticAlgorithm::setup(bool* isSuccess)           // *Out*
     if (*isSuccess == true)
     { // If the user wants defaults, set up the rest of the data
 
-    popSize = 1000;                // Set default population size
-    isStartPiece = true;           // Set default start constraint to active
-    boardSize = 16;                // Set default for piece count check
+    settings.popSize = 1000;       // Set default population size
+    settings.isStartPiece = true;  // Set default start constraint to active
+    settings.boardSize = 16;       // Set default for piece count check
 
     // Ouput the settings using all the defaults
-    outputSettings(16, 22, 1000, 1, 1, 2, 25, 2);
+    outputSettings(16, 22, 1000, 1, 1, 2, 25, 2, 10, 0, 0, 0);
 
     // Calculate the maximum fitness of a 100% solved candidate
-    calcMaxFitness(boardSize);
+    calcMaxFitness(settings.boardSize);
     }
   } // if (inputSuccess == true)
 
-  if (((*BoardManager::getInstance()->getPieces())[0].size() +
-      (*BoardManager::getInstance()->getPieces())[1].size() +
-      (*BoardManager::getInstance()->getPieces())[2].size()) !=
-      (boardSize * boardSize))
+  if (((*boardMan.getPieces())[0].size() +
+      (*boardMan.getPieces())[1].size() +
+      (*boardMan.getPieces())[2].size()) !=
+      (settings.boardSize * settings.boardSize))
   { // Calculate how many pieces are in piece vector and how many it takes to
     // fill a board, if not correct, output error and quit
     OutputError();        // Output error
@@ -129,15 +177,51 @@ void GeneticAlgorithm::OutputError()
 
 
 void GeneticAlgorithm::runGA()
-{ // Main function of the GA that continually runs
+{ // Main function of the GA that runs until enough solutions are found or a
+  // stop limit is reached
 
   int sinceImprove = 200;    // Counts down from 200 for test if stuck
   int prevFitness = 0;       // Holds the previous fitness to check if stuck
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();  // Time the run started
+
+  // Stop what is running and output what was found so far when interrupted
+  catchSignals(true);
+
+  if (settings.isGenerator)
+  { // If generator, write the puzzle corpus instead of solving
+    runGenerator();
+    catchSignals(false);
+    return;
+  }
+
+  if (settings.solverMode == EXHAUSTIVE)
+  { // If exhaustive, search every arrangement instead of running the GA
+    runExhaustive();
+    catchSignals(false);
+    return;
+  }
+
+  if (settings.solverMode == BORDERFIRST)
+  { // If border first, solve and lock the border before the GA starts
+    solveBorder();
+  }
+
+  if (settings.solverMode == EDASOLVER)
+  { // If EDA, start with a model that gives every piece the same chance
+    theEDA.reset();
+  }
+
+  if (settings.solverMode == ACOSOLVER)
+  { // If ACO, start with the same pheromone on every choice
+    theACO.reset();
+  }
 
   initRandomPopulation();    // Initialise the first population
 
-  while (currFitness != maxFitness)
-  { // While the solution has not been found, continue working towards solution
+  while ((int)solutionHashes.size() < settings.solutionCount)
+  { // While not enough distinct solutions have been found, continue working
+    // towards solution
 
     if (prevFitness < currFitness)
     { // If fitness has improved, reset the stuck counter and set new high
@@ -156,13 +240,18 @@ void GeneticAlgorithm::runGA()
              
     doFitness();           // Check fitness of the population
 
+    if (currFitness == maxFitness)
+    { // If a board is solved, output it if it is a new solution
+      outputSolved();
+    }
+
     // Calculate the percentage of fitness complete
     float fitPercent = ((float)currFitness / maxFitness) * 100.0f;
 
     // Calculate the percentage of matches complete
     float matchPercent = ((float)currMatches / maxMatches) * 100.0f;
 
-    if (genCount % 100 == 0)
+    if (genCount % SUMMARYGENS == 0)
     { // Output the generation summary to console and file every 100 generations
 
       // Output to console
@@ -170,31 +259,96 @@ void GeneticAlgorithm::runGA()
              genCount, currFitness, maxFitness, fitPercent, currMatches,
              maxMatches, matchPercent);
 
+      // Output diversity, distinct boards and duplicate offspring rejected
+      printf("Diversity: Unique %d/%d %.2f%%, Rejected %d\n", uniqueCount,
+             settings.popSize,
+             ((float)uniqueCount / settings.popSize) * 100.0f,
+             theCrossover.getRejectCount());
+
+      // Output how many fitness checks were answered by the cache
+      printf("Cache: Hits %lld, Misses %lld %.2f%%\n", theCache.getHits(),
+             theCache.getMisses(), ((double)theCache.getHits() /
+             (theCache.getHits() + theCache.getMisses())) * 100.0);
+
       outputFitness();                      // Output to file
+      theMutation.outputOperators();        // Output adaptive operator mix
     }
 
-    if (sinceImprove > 0)
+    if ((int)solutionHashes.size() < settings.solutionCount &&
+        isStopReached(start))
+    { // If a limit is reached before enough solutions are found, output the
+      // best board so far and stop
+      outputBest();
+      break;
+    }
+
+    if (sinceImprove > 0 && settings.solverMode == EDASOLVER)
+    { // If fitness improvement has been made in past 200 generations and in
+      // EDA mode, learn from the best boards and sample the next generation
+      theEDA.doGeneration(settings.popSize, theCrossover.getEliteRate());
+      theMutation.setStagnation(200 - sinceImprove); // Scale adaptive rate
+      theMutation.doMutation();
+    }
+    else if (sinceImprove > 0 && settings.solverMode == ACOSOLVER)
+    { // If fitness improvement has been made in past 200 generations and in
+      // ACO mode, lay pheromone from the best boards and send out new ants
+      theACO.doGeneration(settings.popSize, theCrossover.getEliteRate());
+      theMutation.setStagnation(200 - sinceImprove); // Scale adaptive rate
+      theMutation.doMutation();
+    }
+    else if (sinceImprove > 0 && (settings.gaMode == STEADYWORST ||
+                             settings.gaMode == STEADYTOURNAMENT))
+    { // If fitness improvement has been made in past 200 generations and in
+      // steady state mode, replace the population one child at a time
+      theMutation.setStagnation(200 - sinceImprove); // Scale adaptive rate
+      doSteadyState();
+    }
+    else if (sinceImprove > 0 && settings.gaMode == FUSED)
+    { // If fitness improvement has been made in past 200 generations and in
+      // fused mode, finish each child of the new generation in one pass
+      theMutation.setStagnation(200 - sinceImprove); // Scale adaptive rate
+      doFused();
+    }
+    else if (sinceImprove > 0)
     { // If fitness improvement has been made in past 200 generations, keep
       // trying to solve
 
       // Switch current population to previous and create new population
-      BoardManager::getInstance()->switchPop();
+      boardMan.switchPop();
 
-      theCrossover.doCrossover(popSize);    // Complete crossover of population
-      theMutation.doMutation(isStartPiece); // Complete mutation of population
+      // Complete crossover of population
+      theCrossover.doCrossover(settings.popSize);
+      theMutation.setStagnation(200 - sinceImprove); // Scale adaptive rate
+
+      // Complete mutation of population
+      theMutation.doMutation();
+    }
+    else if (escapePlateau(prevFitness))
+    { // If 200 generations have passed without improved fitness but tabu search
+      // on the best candidate found a better board, carry on from there
+      sinceImprove = 200;                   // Reset counter
     }
     else
-    { // If 200 generations have passed without immproved fitness, reset 
-      // population and fitness to try again
-      initRandomPopulation();               // Get new population
+    { // If 200 generations have passed without immproved fitness, restart
+      // population with the restart policy and try again
+      restartPopulation(&prevFitness);      // Restart population in place
+
+      if (settings.solverMode == EDASOLVER)
+      { // If EDA, forget the model learnt from the old population
+        theEDA.reset();
+      }
+
+      if (settings.solverMode == ACOSOLVER)
+      { // If ACO, forget the pheromone laid by the old population
+        theACO.reset();
+      }
       sinceImprove = 200;                   // Reset counter
-      prevFitness = 0;                      // Reset previous fitness
       currFitness = 0;                      // Reset current fitness
     }
 
-  } // while (currFitness != maxFitness)
+  } // while ((int)solutionHashes.size() < settings.solutionCount)
 
-  outputSolved();                         // Output the solved board
+  catchSignals(false);                 // Signals end the process again
 
 } // runGA()
 
@@ -214,6 +368,24 @@ void GeneticAlgorithm::genRandomNum(int min,            // *In*
 } // genRandomNum()
 
 
+void GeneticAlgorithm::genRandomBatch(int min,          // *In*
+                                      int max,          // *In*
+                                      int count,        // *In*
+                                      int* randNums)    // *Out*
+{ // Generates count random numbers between min and max in to randNums,
+  // working out the range once for the whole batch
+
+  // Work out range between min and max (+1 to include max afterwards)
+  int range = (max - min) + 1;
+
+  for (int i = 0; i < count; i++)
+  { // Get random number between 0 and the range, then add min
+    randNums[i] = (std::rand() % range) + min;
+  }
+
+} // genRandomBatch()
+
+
 void GeneticAlgorithm::calcMaxFitness(int boardSize)          // *In*
 { // Takes in the size of board and calculates what the fitness of a 100%
   // solved candidate would be so the algorithm can quit when goal is achieved
@@ -243,51 +415,443 @@ void GeneticAlgorithm::initRandomPopulation()
   std::vector<Board> newPop;
 
   // Make sure the population is empty in case of scramble repair
-  BoardManager::getInstance()->getPop()->clear();
+  boardMan.getPop()->clear();
 
   // Set the current population pointer to new population vector
-  BoardManager::getInstance()->getPop() =
-    std::make_shared<std::vector<Board>>(newPop);
+  boardMan.getPop() = std::make_shared<std::vector<Board>>(newPop);
 
-  for (int i = 0; i < popSize; i++)
+  for (int i = 0; i < settings.popSize; i++)
   { // Create initialise population of boards with randomised boards
     Board newBoard;   // Create new board
 
     // Fill board with random pieces
-    BoardManager::getInstance()->initFullBoard(&newBoard, isStartPiece);
+    boardMan.initFullBoard(&newBoard);
 
     // Set board ID
-    newBoard.boardID = (int)BoardManager::getInstance()->getPop()->size() + 1;
+    newBoard.boardID = (int)boardMan.getPop()->size() + 1;
 
     // Push onto population
-    BoardManager::getInstance()->getPop()->push_back(newBoard);
+    boardMan.getPop()->push_back(newBoard);
   }
 
 } // initRandomPopulation()
 
 
+void GeneticAlgorithm::restartPopulation(int* prevFitness)    // *In-Out*
+{ // Restarts a population that has stopped improving in place using the
+  // restart policy chosen. Full refills every board, keep elite refills all
+  // but the elites and mutate best fills the population with heavily mutated
+  // copies of the best board. Previous fitness is only reset by full restart.
+  // Border first solves the border again first, and as the kept boards hold
+  // the old ring every board is refilled around the new one
+
+  std::shared_ptr<std::vector<Board>> thePop =
+    boardMan.getPop();                             // Population to restart
+  std::vector<int> order(thePop->size());          // Board indexes, best first
+  int keepCount = 0;                               // Boards kept as they are
+  int moves = 0;                                   // Mutations per copy
+  RestartPolicy policy = settings.restartMethod;   // Restart policy to use
+
+  for (int i = 0; i < (int)order.size(); i++)
+  { // Fill with the index of each board
+    order[i] = i;
+  }
+
+  if (settings.solverMode == BORDERFIRST)
+  { // The ring may be why the population is stuck, so unlock it and solve a
+    // new one from a new order of pieces, then refill every board around it
+    solveBorder();
+    policy = FULLRESTART;
+  }
+
+  if (policy == KEEPELITE)
+  { // Keep the elites, always keeping at least the best board
+    keepCount = std::max(1, theCrossover.getEliteRate());
+  }
+  else if (policy == MUTATEBEST)
+  { // Keep the best board to make the copies from
+    keepCount = 1;
+  }
+
+  keepCount = std::min(keepCount, (int)order.size());
+
+  // Only the boards being kept need to be in order, best first
+  std::partial_sort(order.begin(), order.begin() + keepCount, order.end(),
+                    [&thePop](int a, int b) { return thePop->at(b) <
+                                                     thePop->at(a); });
+
+  // Work out how many mutations each copy of the best board gets
+  moves = ((boardMan.getSize() + 1) * (boardMan.getSize() + 1)) / RESTARTMOVES;
+
+  for (int i = keepCount; i < (int)order.size(); i++)
+  { // Replace every board that is not kept, reusing its storage
+
+    if (policy == MUTATEBEST)
+    { // Copy the best board over the board then mutate it heavily
+      thePop->at(order[i]).boardVecs = thePop->at(order[0]).boardVecs;
+      thePop->at(order[i]).hash = thePop->at(order[0]).hash;
+      theMutation.scramble(order[i], moves);
+    }
+    else
+    { // Refill the board with a random order of pieces
+      boardMan.refillBoard(&thePop->at(order[i]));
+    }
+  }
+
+  if (policy == FULLRESTART)
+  { // Nothing was kept, so the previous best no longer exists
+    *prevFitness = 0;
+  }
+
+} // restartPopulation()
+
+
 void GeneticAlgorithm::doFitness()
 { // Checks the fitness of the population and checks to see if there is a new
-  // fitness or pattern match record
+  // fitness or pattern match record. Crowding compares the scored children
+  // with their parents before the records. On summary generations the
+  // distinct boards are counted by their canonical hash so turned copies of a
+  // board are only counted once. The best board so far is copied only when it
+  // is beaten, and solved boards are noted as they are found so neither needs
+  // another pass
+
+  std::unordered_set<unsigned long long> hashes;  // Hashes seen this gen
+  std::vector<int> unchecked;                     // Boards missed by cache
+  bool isSummary = genCount % SUMMARYGENS == 0;   // Diversity is output
+
+  for (int i = 0; i < settings.popSize && !isScored; i++)
+  { // Loop through every boards of population checking the fitness, unless
+    // the same board was checked before and is still in the cache
+    Board* theBoard = &boardMan.getPop()->at(i);
+
+    if (theCache.lookup(theBoard))
+    { // Cached, fitness already set
+      continue;
+    }
 
-  for (int i = 0; i < popSize; i++)
-  { // Loop through every boards of population checking the fitness
-    theFitness.checkFitness(&BoardManager::getInstance()->getPop()->at(i));
+    if (settings.isBatchFitness)
+    { // Batch checks wait until every board not in the cache is known
+      unchecked.push_back(i);
+    }
+    else
+    { // If not cached, do full check and remember the result
+      theFitness.checkFitness(theBoard);
+      theCache.store(theBoard);
+    }
+  }
 
-    if (BoardManager::getInstance()->getPop()->at(i).matchCount > currMatches)
+  if (!unchecked.empty())
+  { // Check the boards missed by the cache side by side, then remember them
+    theFitness.checkBatch(boardMan.getPop().get(), unchecked);
+
+    for (int index : unchecked)
+    {
+      theCache.store(&boardMan.getPop()->at(index));
+    }
+  }
+
+  // With crowding, put back any parent that beats its finished child
+  theCrossover.doCrowding();
+
+  if (settings.isMismatchBias)
+  { // If mismatch bias is on, start a new heatmap for this generation
+    boardMan.clearHeatmap();
+  }
+
+  solvedIndexes.clear();              // No boards of this gen solved yet
+
+  for (int i = 0; i < settings.popSize; i++)
+  { // Loop through every board of the population for the records
+    if (isSummary)
+    { // Only the summary outputs the diversity, so only hash for it then
+      hashes.insert(boardMan.getCanonicalHash(&boardMan.getPop()->at(i)));
+    }
+
+    if (settings.isMismatchBias)
+    { // Add the mismatched edges of the board to the heatmap
+      theFitness.addMismatches(&boardMan.getPop()->at(i));
+    }
+
+    if (boardMan.getPop()->at(i).matchCount > currMatches)
     { // Check to see if new highest match count
-      currMatches = BoardManager::getInstance()->getPop()->at(i).matchCount;
+      currMatches = boardMan.getPop()->at(i).matchCount;
     }
 
-    if (BoardManager::getInstance()->getPop()->at(i).fitScore > currFitness)
+    if (boardMan.getPop()->at(i).fitScore > currFitness)
     { // If next maximum fitness of generation found, store new max fitness
-      currFitness = BoardManager::getInstance()->getPop()->at(i).fitScore;
+      currFitness = boardMan.getPop()->at(i).fitScore;
+    }
+
+    if (boardMan.getPop()->at(i).fitScore > bestFitness)
+    { // If the best board of the run is beaten, keep a copy of the new best
+      bestFitness = boardMan.getPop()->at(i).fitScore;
+      bestBoard = boardMan.getPop()->at(i);
+      bestGen = genCount;
+    }
+
+    if (boardMan.getPop()->at(i).fitScore == maxFitness)
+    { // If the board is solved, note it for output
+      solvedIndexes.push_back(i);
     }
   }
 
+  if (isSummary)
+  { // Store diversity of the population
+    uniqueCount = (int)hashes.size();
+  }
+
+  if (settings.isMismatchBias)
+  { // Point mutation at the slots that mismatched in this generation
+    theMutation.loadHeatmap();
+  }
+  isScored = false;                   // Next population has to be checked
+
 } // doFitness()
 
 
+void GeneticAlgorithm::doSteadyState()
+{ // Replaces the population one pair of children at a time in place for
+  // steady state mode. Each child replaces the worst board or the loser of a
+  // tournament and is mutated and scored straight away, so parents selected
+  // later in the generation can be children from earlier in the generation.
+  // With crowding each child takes the slot of the parent it is most like
+  // and the parent is put back if it is better than the finished child
+
+  Board* offspring[2];       // Children bred in to the crossover scratch boards
+  Board rival;               // Parent a crowding child competes with
+  int victim = -1;           // Index of the board a child replaces
+  bool isCrowding = (settings.selectMethod == CROWDING);
+
+  // Select parents from the population being replaced
+  theCrossover.beginSteadyState(settings.popSize);
+
+  for (int step = 0; step < settings.popSize / 2; step++)
+  { // Breed a pair of children for every two boards in the population
+
+    theCrossover.breedChildren(settings.popSize, offspring);
+
+    for (int i = 0; i < 2; i++)
+    { // Copy each child over the board it replaces then mutate and score it
+      victim = theCrossover.getReplaceIndex(settings.popSize,
+                                  settings.gaMode == STEADYTOURNAMENT, i);
+
+      Board* theBoard = &boardMan.getPop()->at(victim);
+
+      if (isCrowding)
+      { // Keep the parent in case it beats the finished child
+        rival = *theBoard;
+      }
+
+      *theBoard = *offspring[i];
+      theBoard->boardID = victim + 1;
+
+      theMutation.mutateChild(victim);
+
+      if (!theCache.lookup(theBoard))
+      { // If not cached, do full check and remember the result
+        theFitness.checkFitness(theBoard);
+        theCache.store(theBoard);
+      }
+
+      if (isCrowding && *theBoard < rival)
+      { // If the parent is better than the child, put the parent back
+        *theBoard = rival;
+      }
+
+      // Let selection see the fitness of the board now in the slot
+      theCrossover.updateFitness(victim, theBoard->fitScore);
+    }
+  }
+
+} // doSteadyState()
+
+
+void GeneticAlgorithm::doFused()
+{ // Breeds the next generation with each pair of children bred, mutated and
+  // scored before the next pair is started, so every child is finished while
+  // it is still in the cache instead of the population being walked by
+  // crossover, mutation and fitness in turn
+
+  Board* offspring[2];       // Children bred in to the new population
+  int popCount = 0;          // Holds how many offspring have been finished
+
+  // Switch current population to previous and size the new population
+  boardMan.switchPop();
+  int offspringCount = theCrossover.beginGeneration(settings.popSize);
+
+  while (popCount < offspringCount)
+  { // Breed the next pair, trying again in the same slots if it was a copy
+
+    if (!theCrossover.breedPair(settings.popSize, popCount, offspring))
+    {
+      continue;
+    }
+
+    for (int i = 0; i < 2; i++)
+    { // Mutate each child with the chance every board has, then score it
+      theMutation.mutateChild(popCount + i);
+
+      if (!theCache.lookup(offspring[i]))
+      { // If not cached, do full check and remember the result
+        theFitness.checkFitness(offspring[i]);
+        theCache.store(offspring[i]);
+      }
+    }
+
+    popCount += 2;           // Increment offspring count by 2
+  }
+
+  // Transfer the elites over, they keep the fitness of the last generation
+  theCrossover.doElitism(popCount);
+
+  isScored = true;           // Fitness check only has to gather the records
+
+} // doFused()
+
+
+void GeneticAlgorithm::solveBorder()
+{ // Phase one of the border first pipeline. Unlocks any ring locked before,
+  // then solves the border ring alone and locks it in every board, so the GA
+  // only has to place the inner pieces. A ring that does not close can not be
+  // part of a solution, so it is not locked and the GA places the border too
+
+  Board ringBoard;                     // Board to solve the ring within
+  bool isClosed = false;               // Whether the whole ring matched
+
+  theBorder.unlockBorder();            // Free the border of any old ring
+  boardMan.initFullBoard(&ringBoard);  // Start from a board of all the pieces
+
+  isClosed = theBorder.solve(&ringBoard);
+
+  if (isClosed)
+  { // Lock the ring in every board and store its score for the fitness checks
+    theBorder.lockBorder(&ringBoard);
+    theFitness.fixRing(&ringBoard);
+
+    printf("Border: Solved, %d/%d ring matches\n\n",
+           boardMan.getRingMatches(), (boardMan.getSize() + 1) * 4 - 4);
+  }
+  else
+  { // Leave the border free so every board can still reach a solution
+    printf("Border: Not closed, border left to the GA\n\n");
+  }
+
+} // solveBorder()
+
+
+void GeneticAlgorithm::runExhaustive()
+{ // Searches every arrangement of the pieces across every hardware thread,
+  // outputting the first SolutionCount solutions found and how many there are
+  // in total, or that there are none. Stops early on interrupt or once the
+  // time limit passes, outputting what was found so far
+
+  theExhaustive.solve(settings.solutionCount, settings.timeLimit,
+                      &isStopRequested);
+
+  for (Board& solution : *theExhaustive.getSolutions())
+  { // Output each kept solution
+    theFile.outputBoard(&solution, 0);
+  }
+
+  printf("Exhaustive: %lld solutions, %lld nodes in %.2fs, %.0f nodes/s\n",
+         theExhaustive.getSolutionCount(), theExhaustive.getNodeCount(),
+         theExhaustive.getSeconds(), theExhaustive.getNodeCount() /
+         std::max(theExhaustive.getSeconds(), 0.001));
+
+  if (theExhaustive.getIsStopped())
+  { // Counts only cover the part of the tree searched before the stop
+    printf("Stopped: %s, search not finished\n",
+           isStopRequested ? "Interrupted" : "Time limit reached");
+  }
+  else if (theExhaustive.getSolutionCount() == 0)
+  { // Whole tree searched without a solution
+    printf("No solution exists\n");
+  }
+
+} // runExhaustive()
+
+
+void GeneticAlgorithm::runGenerator()
+{ // Writes a corpus of puzzles for every size and pattern count set in
+  // generator.ini, each set generated across every hardware thread. Stops
+  // between sets on interrupt
+
+  GeneratorSettings corpus;            // Settings of the corpus
+  std::vector<GeneratedPuzzle> puzzles;  // Puzzles of the current set
+  bool isSuccess = true;               // Whether generator.ini was valid
+  int puzzleCount = 0;                 // Puzzles written so far
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();  // Time generating started
+
+  theFile.readGeneratorFile(&corpus, &isSuccess);
+
+  if (!isSuccess)
+  { // Nothing can be generated without valid settings
+    printf("Generator: generator.ini is missing or not valid\n");
+    return;
+  }
+
+  theFile.startCorpus();               // Make the directory and manifest
+
+  for (int size = corpus.minSize; size <= corpus.maxSize && !isStopRequested;
+       size++)
+  { // Generate a set for every size, stopping between sets if interrupted
+    for (int pattern = corpus.minPatterns;
+         pattern <= corpus.maxPatterns && !isStopRequested; pattern++)
+    { // And every pattern count within the size
+
+      theGenerator.generateSet(size, pattern, corpus.puzzleCount,
+                               corpus.seed, corpus.isOfficialStyle, &puzzles);
+
+      for (GeneratedPuzzle& puzzle : puzzles)
+      { // Write each puzzle of the set and add it to the manifest
+        theFile.outputPuzzle(&puzzle, corpus.isOfficialStyle,
+                             corpus.isBinary);
+      }
+
+      puzzleCount += (int)puzzles.size();
+    }
+  }
+
+  if (isStopRequested)
+  { // Only the sets finished before the interrupt were written
+    printf("Stopped: Interrupted\n");
+  }
+
+  printf("Generator: %d puzzles in %.2fs\n", puzzleCount,
+         std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start).count());
+
+} // runGenerator()
+
+
+bool GeneticAlgorithm::escapePlateau(int prevFitness)          // *In*
+{ // Runs tabu search on the best candidate of a population that has stopped
+  // improving, returns whether the search beat the previous best fitness so
+  // the population can carry on instead of being scrambled
+
+  int bestIndex = 0;      // Index of the best candidate in the population
+
+  for (int i = 1; i < settings.popSize; i++)
+  { // Loop through the population to find the best candidate
+    if (boardMan.getPop()->at(bestIndex) < boardMan.getPop()->at(i))
+    { // If candidate is better than the best found, store index
+      bestIndex = i;
+    }
+  }
+
+  // Run tabu search on the best candidate, leaving the result in place
+  theTabu.search(&boardMan.getPop()->at(bestIndex), TABUITERATIONS);
+
+  // Rehash the board as tabu search moves pieces without updating the hash
+  boardMan.hashBoard(&boardMan.getPop()->at(bestIndex));
+
+  // Return whether the search improved on the best fitness reached
+  return boardMan.getPop()->at(bestIndex).fitScore > prevFitness;
+
+} // escapePlateau()
+
+
 void GeneticAlgorithm::outputSettings(int boardSize,           // *In*
                                       int patternNum,          // *In*
                                       int popSize,             // *In*
@@ -295,15 +859,19 @@ void GeneticAlgorithm::outputSettings(int boardSize,           // *In*
                                       int crossMethod,         // *In*
                                       int mutMethod,           // *In*
                                       double mutRate,          // *In*
-                                      int eliteRate)           // *In* 
+                                      int eliteRate,           // *In*
+                                      int tournamentSize,      // *In*
+                                      int restartMethod,       // *In*
+                                      int gaMode,              // *In*
+                                      int solverMode)          // *In*
 { // Outputs all of the loaded settings so the user can see what methods are
   // used for solving attempt
 
   // Print out the data on the board along with the population size, mutation
   // rate and elitism rate
   printf("Board Size: %i\nNumber of Patterns: %i\nPopulation Size: %i\n"
-         "Mutation Rate: %.2f%%\nElitism Rate: %i\n", boardSize, patternNum, 
-         popSize, mutRate, eliteRate);
+         "Mutation Rate: %.2f%%\nElitism Rate: %i\nTournament Size: %i\n",
+         boardSize, patternNum, popSize, mutRate, eliteRate, tournamentSize);
 
   // Print out the enum value as a string for selection
   if (selectMethod == 0)
@@ -314,6 +882,10 @@ void GeneticAlgorithm::outputSettings(int boardSize,           // *In*
   { // If 1, print tournament 
     printf("Selection: Tournament\n");
   }
+  else if (selectMethod == 2)
+  { // If 2, print deterministic crowding
+    printf("Selection: Deterministic Crowding\n");
+  }
 
   // Print out the enum value as a string for crossover
   if (crossMethod == 0)
@@ -325,6 +897,60 @@ void GeneticAlgorithm::outputSettings(int boardSize,           // *In*
     printf("Crossover: Two-Point\n");
   }
 
+  // Print out the enum value as a string for restart policy
+  if (restartMethod == 0)
+  { // If 0, print full
+    printf("Restart: Full\n");
+  }
+  else if (restartMethod == 1)
+  { // If 1, print keep elite
+    printf("Restart: Keep Elite\n");
+  }
+  else if (restartMethod == 2)
+  { // If 2, print mutate best
+    printf("Restart: Mutate Best\n");
+  }
+
+  // Print out the enum value as a string for GA mode
+  if (gaMode == 0)
+  { // If 0, print generational
+    printf("GA Mode: Generational\n");
+  }
+  else if (gaMode == 1)
+  { // If 1, print steady state replacing the worst
+    printf("GA Mode: Steady-State Worst\n");
+  }
+  else if (gaMode == 2)
+  { // If 2, print steady state replacing tournament loser
+    printf("GA Mode: Steady-State Tournament\n");
+  }
+  else if (gaMode == 3)
+  { // If 3, print fused
+    printf("GA Mode: Fused\n");
+  }
+
+  // Print out the enum value as a string for solver mode
+  if (solverMode == 0)
+  { // If 0, print GA
+    printf("Solver: GA\n");
+  }
+  else if (solverMode == 1)
+  { // If 1, print border first
+    printf("Solver: Border First\n");
+  }
+  else if (solverMode == 2)
+  { // If 2, print EDA
+    printf("Solver: EDA\n");
+  }
+  else if (solverMode == 3)
+  { // If 3, print ACO
+    printf("Solver: ACO\n");
+  }
+  else if (solverMode == 4)
+  { // If 4, print exhaustive
+    printf("Solver: Exhaustive\n");
+  }
+
   // Print out the enum value as a string for mutation
   if (mutMethod == 0)
   { // If 0, print swap
@@ -346,6 +972,18 @@ void GeneticAlgorithm::outputSettings(int boardSize,           // *In*
   { // If 4, print region rotate
     printf("Mutation: Region Rotate\n\n");
   }
+  else if (mutMethod == 5)
+  { // If 5, print guided swap
+    printf("Mutation: Guided Swap\n\n");
+  }
+  else if (mutMethod == 6)
+  { // If 6, print region match
+    printf("Mutation: Region Match\n\n");
+  }
+  else if (mutMethod == 7)
+  { // If 7, print adaptive
+    printf("Mutation: Adaptive\n\n");
+  }
 
 } // outputSettings()
 
@@ -353,26 +991,123 @@ void GeneticAlgorithm::outputSettings(int boardSize,           // *In*
 void GeneticAlgorithm::outputFitness()
 { // Calls to ouput the current fitness to the file for record of performance
 
-  FileHandler fileHandle;                          // Create object for output
-  fileHandle.outputFitness(genCount, currFitness); // Call to output the fitness
+  theFile.outputFitness(genCount, currFitness);    // Call to output the fitness
+
+  if (settings.isMismatchBias)
+  { // If the heatmap is being kept, output it after the fitness
+    theFile.outputHeatmap(genCount);
+  }
 
 } // outputFitness()
 
 
 void GeneticAlgorithm::outputSolved()
-{ // Output the solved bored along with how many generation it took to solve
+{ // Output each solved board not already output along with how many
+  // generations it took to solve. Boards are turned to their canonical turn
+  // first, so the four turns of a solution are only output once
 
-  FileHandler fileHandle;                     // Filehandler to output to file
+  for (int i = 0; i < (int)solvedIndexes.size() &&
+                  (int)solutionHashes.size() < settings.solutionCount; i++)
+  { // Loop through the solved boards noted by the fitness check, turning
+    // each and checking it is new
 
-  for (int i = 0; i < popSize; i++)
-  { // Loop through the population, checking to see which candidate is solved
+    Board* theBoard = &boardMan.getPop()->at(solvedIndexes[i]);
 
-    if (BoardManager::getInstance()->getPop()->at(i).fitScore == maxFitness)
-    { // If board fitness is max fitness, call to output the board
-      fileHandle.outputBoard(&BoardManager::getInstance()->getPop()->at(i),
-                          genCount);
-      break;        // Break out of loop when board has been output
+    boardMan.canonicalise(theBoard);
+
+    if (solutionHashes.insert(theBoard->hash).second)
+    { // If the solution has not been seen, call to output the board
+      theFile.outputBoard(theBoard, genCount);
     }
   }
 
-} // outputSolved()
\ No newline at end of file
+} // outputSolved()
+
+
+bool GeneticAlgorithm::isStopReached(
+  std::chrono::steady_clock::time_point start)               // *In*
+{ // Checks the time, generation, evaluation and target match limits along with
+  // whether the run was interrupted, outputting why the run is stopping if it
+  // is
+
+  bool isStop = true;        // Holds if the run should stop
+
+  // Seconds since the run started
+  double seconds = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  if (isStopRequested)
+  { // If a signal arrived, stop straight away
+    printf("Stopped: Interrupted\n");
+  }
+  else if (settings.timeLimit > 0 && seconds >= settings.timeLimit)
+  { // If the time limit has passed, stop
+    printf("Stopped: Time limit of %ds reached\n", settings.timeLimit);
+  }
+  else if (settings.generationLimit > 0 &&
+           genCount >= settings.generationLimit)
+  { // If the generation limit has been run, stop
+    printf("Stopped: Generation limit of %d reached\n",
+           settings.generationLimit);
+  }
+  else if (settings.evaluationLimit > 0 &&
+           boardMan.getCheckCount() >= settings.evaluationLimit)
+  { // If the evaluation limit has been used, stop
+    printf("Stopped: Evaluation limit of %d reached\n",
+           settings.evaluationLimit);
+  }
+  else if (settings.targetMatch < 100 &&
+           currMatches * 100 >= settings.targetMatch * maxMatches)
+  { // If the target match percentage has been reached, stop. At 100 only
+    // enough solutions stop the run
+    printf("Stopped: Target match of %d%% reached\n", settings.targetMatch);
+  }
+  else
+  { // No limit reached, carry on
+    isStop = false;
+  }
+
+  return isStop;             // Return whether the run should stop
+
+} // isStopReached()
+
+
+void GeneticAlgorithm::outputBest()
+{ // Outputs the best board found so far along with the generation it was found
+  // in, used when the run stops before it is solved
+
+  if (bestFitness < 0)
+  { // If no board has been checked there is nothing to output
+    return;
+  }
+
+  printf("Best: Fitness %d/%d %.2f%%, Match Count %d/%d %.2f%%, "
+         "Generation %d, Evaluations %lld\n", bestBoard.fitScore, maxFitness,
+         ((float)bestBoard.fitScore / maxFitness) * 100.0f,
+         bestBoard.matchCount, maxMatches,
+         ((float)bestBoard.matchCount / maxMatches) * 100.0f, bestGen,
+         boardMan.getCheckCount());
+
+  theFile.outputBoard(&bestBoard, bestGen);  // Output the best board to file
+
+} // outputBest()
+
+
+void GeneticAlgorithm::onSignal(int signal)                   // *In*
+{ // Called on interrupt or terminate, sets the stop flag so the mode
+  // running stops and outputs what it has found before exiting
+
+  std::signal(signal, &GeneticAlgorithm::onSignal);  // Catch it again
+  isStopRequested = 1;
+
+} // onSignal()
+
+
+void GeneticAlgorithm::catchSignals(bool isCaught)             // *In*
+{ // Catches interrupt and terminate with onSignal, or hands them back to the
+  // default handler so they end the process again
+
+  std::signal(SIGINT, isCaught ? &GeneticAlgorithm::onSignal : SIG_DFL);
+  std::signal(SIGTERM, isCaught ? &GeneticAlgorithm::onSignal : SIG_DFL);
+
+} // catchSignals()
\ No newline at end of file
@@ -10,22 +10,60 @@
 #include "FitnessFunction.h"        // Evalute fitness in GA process
 #include "Crossover.h"              // Crossover of candidates
 #include "Mutation.h"               // Mutation of candidates
+#include "TabuSearch.h"             // Escaping plateaus with local search
+#include "FitnessCache.h"           // Skipping fitness checks of repeats
+#include "BorderSolver.h"           // Solving the border ring first
+#include "EDASolver.h"              // Sampling boards from a learnt model
+#include "ACOSolver.h"              // Building boards with an ant colony
+#include "ExhaustiveSolver.h"       // Searching every arrangement
+#include "PuzzleGenerator.h"        // Generating puzzle corpora
+#include "FileHandler.h"            // File input and output
+#include "Settings.h"               // Settings of the solve attempt
+#include <unordered_set>            // Hashes of solutions already found
+#include <chrono>                   // Time limit of the run
+#include <csignal>                  // Stopping on interrupt or terminate
+
+
+#define RESTARTMOVES 4              // Slots of the board per rotate & swap
+                                    // when mutating copies of the best board
+#define SUMMARYGENS 100             // Generations between summary outputs
 
 
 class GeneticAlgorithm
 {
 
 private:
-  int popSize;                          // Holds the population size
+  Settings settings;                    // Settings read for this attempt
   int maxFitness;                       // Fitness of 100% candidate
   int currFitness;                      // Holds the max fitness of current gen
   int currMatches;                      // Max num pattern matches reached
   int maxMatches;                       // Max num of pattern matches at 100%
   int genCount;                         // Count of how many generations passed
-  bool isStartPiece;                    // Switch for start piece constraint
+  int uniqueCount;                      // Distinct boards in current gen
+  bool isScored;                        // Whether population already scored
+  int bestFitness;                      // Fitness of the best board so far
+  int bestGen;                          // Generation best board was found in
+  Board bestBoard;                      // Best board found so far
+  std::vector<int> solvedIndexes;       // Solved boards of current gen
+
+  // Set by the signal handler when the run is interrupted or terminated, read
+  // once a generation so the run can stop and output the best board
+  static volatile std::sig_atomic_t isStopRequested;
+
+  // Canonical hashes of the distinct solutions output so far
+  std::unordered_set<unsigned long long> solutionHashes;
+  BoardManager boardMan;                // Pieces and populations of solver
+  FileHandler theFile;                  // Object to handle file input/output
   Crossover theCrossover;               // Object to handle crossover
   Mutation theMutation;                 // Object to handle mutation
   FitnessFunction theFitness;           // Object ot handle calculating fitness
+  TabuSearch theTabu;                   // Object to handle tabu search
+  FitnessCache theCache;                // Fitness of boards already checked
+  BorderSolver theBorder;               // Object to solve the border ring
+  EDASolver theEDA;                     // Object to sample boards by EDA
+  ACOSolver theACO;                     // Object to build boards by ACO
+  ExhaustiveSolver theExhaustive;       // Object to search every arrangement
+  PuzzleGenerator theGenerator;         // Object to generate puzzle corpora
 
   // Output to the user that there was an issue with the settings file and if
   // the application should continue with default settings (best of from 
@@ -47,9 +85,54 @@ private:
   void initRandomPopulation();
 
   // Checks the fitness of the population and checks to see if there is a new
-  // fitness or pattern match record
+  // fitness or pattern match record, keeping a copy of the best board so far
+  // and the indexes of any solved boards as the records are checked
   void doFitness();
 
+  // Replaces the population one pair of children at a time in place for
+  // steady state mode. Each child replaces the worst board or the loser of a
+  // tournament and is mutated and scored straight away, so parents selected
+  // later in the generation can be children from earlier in the generation.
+  // With crowding each child takes the slot of the parent it is most like
+  // and the parent is put back if it is better than the finished child
+  void doSteadyState();
+
+  // Breeds the next generation with each pair of children bred, mutated and
+  // scored before the next pair is started, so every child is finished while
+  // it is still in the cache instead of the population being walked by
+  // crossover, mutation and fitness in turn
+  void doFused();
+
+  // Restarts a population that has stopped improving in place using the
+  // restart policy chosen. Full refills every board, keep elite refills all
+  // but the elites and mutate best fills the population with heavily mutated
+  // copies of the best board. Previous fitness is only reset by full restart.
+  // Border first solves the border again first, and as the kept boards hold
+  // the old ring every board is refilled around the new one
+  void restartPopulation(int* prevFitness);    // *In-Out*
+
+  // Phase one of the border first pipeline. Unlocks any ring locked before,
+  // then solves the border ring alone and locks it in every board, so the GA
+  // only has to place the inner pieces. A ring that does not close can not be
+  // part of a solution, so it is not locked and the GA places the border too
+  void solveBorder();
+
+  // Searches every arrangement of the pieces across every hardware thread,
+  // outputting the first SolutionCount solutions found and how many there are
+  // in total, or that there are none. Stops early on interrupt or once the
+  // time limit passes, outputting what was found so far
+  void runExhaustive();
+
+  // Writes a corpus of puzzles for every size and pattern count set in
+  // generator.ini, each set generated across every hardware thread. Stops
+  // between sets on interrupt
+  void runGenerator();
+
+  // Runs tabu search on the best candidate of a population that has stopped
+  // improving, returns whether the search beat the previous best fitness so
+  // the population can carry on instead of being scrambled
+  bool escapePlateau(int prevFitness);         // *In*
+
   // Outputs all of the loaded settings so the user can see what methods are
   // used for solving attempt
   void outputSettings(int boardSize,           // *In*
@@ -59,21 +142,49 @@ private:
                       int crossMethod,         // *In*
                       int mutMethod,           // *In*
                       double mutRate,          // *In*
-                      int eliteRate);          // *In*
+                      int eliteRate,           // *In*
+                      int tournamentSize,      // *In*
+                      int restartMethod,       // *In*
+                      int gaMode,              // *In*
+                      int solverMode);         // *In*
 
   // Calls to ouput the current fitness to the file for record of performance
   void outputFitness();
 
-  // Output the solved bored along with how many generation it took to solve
+  // Output each solved board not already output along with how many
+  // generations it took to solve. Boards are turned to their canonical turn
+  // first, so the four turns of a solution are only output once
   void outputSolved();
 
+  // Checks the time, generation, evaluation and target match limits along
+  // with whether the run was interrupted, outputting why the run is stopping
+  // if it is
+  bool isStopReached(std::chrono::steady_clock::time_point start);  // *In*
+
+  // Outputs the best board found so far along with the generation it was
+  // found in, used when the run stops before it is solved
+  void outputBest();
+
+  // Called on interrupt or terminate, sets the stop flag so the mode
+  // running stops and outputs what it has found before exiting
+  static void onSignal(int signal);            // *In*
+
+  // Catches interrupt and terminate with onSignal, or hands them back to the
+  // default handler so they end the process again
+  static void catchSignals(bool isCaught);     // *In*
+
 public:
+  // Creates the board manager of the solver and hands it to every object that
+  // works on the pieces or populations, so solvers do not share any state
+  GeneticAlgorithm();
+
   // Setup the algorithm with the elite, crossover and mutation rates, along 
   // with the size of the population for each generation. Also handles crossover 
   // and mutation methods, isSuccess returns false to exit application
   void setup(bool* isSuccess);                 // *Out*
 
-  // Main function of the GA that continually runs
+  // Main function of the GA that runs until enough solutions are found or a
+  // stop limit is reached
   void runGA();
 
   // Generates a random number between min and max in randNum parameter
@@ -81,5 +192,12 @@ public:
                            int max,            // *In*
                            int* randNum);      // *Out*
 
+  // Generates count random numbers between min and max in to randNums,
+  // working out the range once for the whole batch
+  static void genRandomBatch(int min,          // *In*
+                             int max,          // *In*
+                             int count,        // *In*
+                             int* randNums);   // *Out*
+
 }; // GeneticAlgorithm
 
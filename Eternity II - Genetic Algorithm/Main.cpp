@@ -5,6 +5,7 @@
 
 
 #include "GeneticAlgorithm.h"     // To create and call the GA
+#include <time.h>                 // time()
 
 
 void main()
@@ -15,6 +16,9 @@ void main()
   GeneticAlgorithm theGA;                       // Create algorithm object
   bool isSuccess = true;                        // Algorithm can solve
 
+  // Seed rand once with time for random number generation of every solver
+  srand((unsigned int)time(NULL));
+
   theGA.setup(&isSuccess);                      // Read algorithms settings
 
   if (isSuccess == true)
@@ -0,0 +1,116 @@
+// Title        : ModelSolver.cpp
+// Purpose      : Carries elites over and fills boards for model solvers
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#include "ModelSolver.h"        // Class declaration
+#include <algorithm>            // nth_element(), min(), max()
+#include <thread>               // Worker threads
+
+
+ModelSolver::ModelSolver(BoardManager* manager)             // *In*
+{ // Stores the board manager of the solver and works out how many workers
+  // to make, at least one if the hardware thread count is unknown
+
+  boardMan = manager;               // Board manager of the solver
+  workerCount = (int)std::max(1u, std::thread::hardware_concurrency());
+
+} // ModelSolver()
+
+
+void ModelSolver::rankPopulation(int popSize)               // *In*
+{ // Makes a ranking key for each board of the scored population, so the
+  // boards themselves are never moved
+
+  std::shared_ptr<std::vector<Board>> thePop =
+    boardMan->getPop();                       // Scored population
+
+  keys.resize(popSize);
+
+  for (int i = 0; i < popSize; i++)
+  { // Make a key for each board
+    keys[i].fitScore = thePop->at(i).fitScore;
+    keys[i].matchCount = thePop->at(i).matchCount;
+    keys[i].index = i;
+  }
+
+} // rankPopulation()
+
+
+unsigned int ModelSolver::nextSeed()
+{ // Returns a seed for the generator of a worker drawn from rand, which is
+  // seeded once for the whole run
+
+  return ((unsigned int)std::rand() << 15) ^ std::rand();
+
+} // nextSeed()
+
+
+void ModelSolver::nextPopulation(int popSize,                          // *In*
+                                 int eliteRate,                        // *In*
+                                 const std::function<void(Board*, int)>&
+                                   fill)                               // *In*
+{ // Replaces the ranked population with the best eliteRate boards followed
+  // by new boards. The new boards are split in to one range per worker, the
+  // fill function given is called on each board with the index of the worker
+
+  std::vector<std::thread> threads;           // Running worker threads
+  int keep = std::min(eliteRate, popSize);    // Boards carried over
+  int share = 0;                              // Boards each worker fills
+  int first = 0;                              // First board of a worker
+
+  // Move the keys of the best boards to the end to carry them over
+  std::nth_element(keys.begin(), keys.end() - keep, keys.end());
+
+  // Current population becomes the previous one, reuse the oldest storage
+  boardMan->switchPop();
+  boardMan->getPop()->resize(popSize);
+
+  for (int i = 0; i < keep; i++)
+  { // Copy the best boards in to the start of the new population
+    boardMan->getPop()->at(i) =
+      boardMan->getOldPop()->at(keys.end()[-1 - i].index);
+    boardMan->getPop()->at(i).boardID = i + 1;
+  }
+
+  share = (popSize - keep + workerCount - 1) / workerCount;
+
+  for (int i = 0; i < workerCount; i++)
+  { // Give each worker its own range of boards to fill
+
+    first = keep + i * share;
+
+    if (first < popSize)
+    {
+      threads.push_back(std::thread(&ModelSolver::fillRange, this,
+                                    boardMan->getPop().get(), first,
+                                    std::min(first + share, popSize), i,
+                                    &fill));
+    }
+  }
+
+  for (std::thread& thread : threads)
+  { // Wait for every worker to finish its boards
+    thread.join();
+  }
+
+} // nextPopulation()
+
+
+void ModelSolver::fillRange(std::vector<Board>* thePop,              // *In-Out*
+                            int first,                               // *In*
+                            int last,                                // *In*
+                            int worker,                              // *In*
+                            const std::function<void(Board*, int)>*
+                              fill)                                  // *In*
+{ // Fills the boards of the population given from the first index given up
+  // to but not including the last index given, using the worker given
+
+  for (int i = first; i < last; i++)
+  { // Fill each board of the range
+    thePop->at(i).boardID = i + 1;
+    (*fill)(&thePop->at(i), worker);
+  }
+
+} // fillRange()
\ No newline at end of file
@@ -0,0 +1,51 @@
+// Title        : ModelSolver.h
+// Purpose      : Carries elites over and fills boards for model solvers
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#include "Crossover.h"          // Ranking keys, board definition
+#include <vector>               // Ranking keys
+#include <functional>           // Function filling each board
+
+
+class ModelSolver
+{
+
+protected:
+  BoardManager* boardMan;                    // Board manager of the solver
+  std::vector<EliteKey> keys;                // Ranking keys of population
+  int workerCount;                           // One per hardware thread
+
+  // Stores the board manager of the solver and works out how many workers
+  // to make, at least one if the hardware thread count is unknown
+  ModelSolver(BoardManager* manager);        // *In*
+
+  // Makes a ranking key for each board of the scored population, so the
+  // boards themselves are never moved
+  void rankPopulation(int popSize);          // *In*
+
+  // Returns a seed for the generator of a worker drawn from rand, which is
+  // seeded once for the whole run
+  unsigned int nextSeed();
+
+  // Replaces the ranked population with the best eliteRate boards followed
+  // by new boards. The new boards are split in to one range per worker, the
+  // fill function given is called on each board with the index of the worker
+  void nextPopulation(int popSize,                                // *In*
+                      int eliteRate,                              // *In*
+                      const std::function<void(Board*, int)>& fill); // *In*
+
+private:
+  // Fills the boards of the population given from the first index given up
+  // to but not including the last index given, using the worker given
+  void fillRange(std::vector<Board>* thePop,                      // *In-Out*
+                 int first,                                       // *In*
+                 int last,                                        // *In*
+                 int worker,                                      // *In*
+                 const std::function<void(Board*, int)>* fill);   // *In*
+
+}; // ModelSolver
\ No newline at end of file
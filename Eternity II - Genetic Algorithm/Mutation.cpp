@@ -7,13 +7,22 @@
 #include "Mutation.h"         // Class declaration
 #include "GeneticAlgorithm.h" // Get random number
 #include <iostream>           // Error output
+#include <algorithm>          // min(), max()
+#include <cstdio>             // printf()
 
 
-Mutation::Mutation()
-{ // Initialise mutation method
+Mutation::Mutation(BoardManager* manager)    // *In*
+  : theMatcher(manager), theFitness(manager)
+{ // Initialise mutation method and store the board manager of the solver
 
   mutType = SWAP;   // Initialise mutation method
   mutNum = 25;      // Initialise number of mutation per gen
+  baseMutNum = 25;  // Initialise number of mutation when not stuck
+  mutPopSize = 1;   // Initialise number of boards in population
+  boardMan = manager; // Board manager of the solver
+  touchCount = 0;   // No slots noted yet
+  touchGain = 0;    // No gain scored yet
+  isTouchNoted = false; // Only noted while scoring adaptive mutations
 
 } // Mutation()
 
@@ -24,12 +33,17 @@ void Mutation::setup(MutateType type,          // *In*
 { // Sets the method of mutation to use for this attempt
 
   mutType = type;                 // Set mutation method
+  mutPopSize = popSize;           // Store size for steady state mutation
   calcMutRate(rate, popSize);     // Calc how many mutation per generation
 
+  // Every operator starts with an equal chance and no reward in adaptive mode
+  opQuality.assign(ADAPTIVE, 0.0);
+  opProb.assign(ADAPTIVE, 1.0 / ADAPTIVE);
+
 } // setup()
 
 
-void Mutation::doMutation(bool startPiece)     // *In*
+void Mutation::doMutation()
 { // Randomly selects a board from the current population to be mutated
   // then calls the appropriate subrountine that will do the needed mutation
   // method on that board.
@@ -41,181 +55,328 @@ void Mutation::doMutation(bool startPiece)     // *In*
     // application start up
 
     // Get a random board ID to complete mutation on
-    GeneticAlgorithm::genRandomNum(0, (int)BoardManager::getInstance()->
-      getPop()->size() - 1, &boardID);
+    GeneticAlgorithm::genRandomNum(0, (int)boardMan->getPop()->size() - 1,
+                                   &boardID);
 
-    if (mutType == SWAP)   
-    { // If mutation method is swap, do swap
-      swap(boardID, startPiece);
-    }
-    else if (mutType == ROTATE)
-    { // If mutation rotate method is , do rotate
-      rotate(boardID, startPiece);
-    }
-    else if (mutType == ROTATESWAP)
-    { // If mutation method is rotate & swap, do rotate & swap
-      rotateSwap(boardID, startPiece);
-    }
-    else if (mutType == REGIONSWAP)
-    { // If mutation method is region swap, do region swap
-      regionSwap(boardID, startPiece);
-    }
-    else if (mutType == REGIONROTATE)
-    {  // If mutation method is region rotate, do region rotate
-      regionRotate(boardID, startPiece);
-    }
-    else       
-    { // Mutation method not recognised, output error
-      std::cout << "Mutation method not recognised" << std::endl;
-    }
+    mutateOne(boardID);
   }
 
 } // doMutation()
 
 
-void Mutation::calcMutRate(double rate,        // *In*
-                           int popSize)        // *In*
-{ // Calculates how many mutations to implement per generation
+void Mutation::mutateOne(int boardID)          // *In*
+{ // Applies one mutation to the board with the ID given, using the mutation
+  // method set or an operator chosen by adaptive mode
 
-  mutNum = (rate * popSize) / 100;    // See above
+  MutateType chosen = mutType;  // Method used for this mutation
 
-} // calcMutRate()
+  if (mutType == ADAPTIVE)
+  { // If adaptive, choose an operator and note the slots it changes, so the
+    // operator is rewarded with the improvement it made without a full check
+    Board* theBoard = &boardMan->getPop()->at(boardID);
 
+    chosen = chooseOperator();
+    touchCount = 0;
+    touchGain = 0;
+    isTouchNoted = true;
 
-void Mutation::getRandPiece(int index[2],      // *Out*
-                            int type,          // *In*
-                            bool startPiece,   // *In*
-                            bool region)       // *In*
-{ // Sets the 2 dimensional index for a random piece with the type given
-  // as a parameter (0 = corner, 1 = edge, 2 = inner)
+    mutateBoard(boardID, chosen);
 
-  if (type == 0)
-  { // If type is inner, call to get a random corner index
-    getRandCorner(index);
-  }
-  else if (type == EDGE)
-  { // If type is edge, call to get a random edge index
-    getRandEdge(index);
+    isTouchNoted = false;
+    rewardOperator(chosen, touchGain + scoreTouched(theBoard));
   }
   else
-  { // If type is inner, call to get random edge index
-    getRandInner(index, startPiece, region);
+  { // Otherwise use the mutation method set for this attempt
+    mutateBoard(boardID, mutType);
   }
 
-} // getRandPiece()
+} // mutateOne()
+
 
+void Mutation::mutateChild(int boardID)        // *In*
+{ // Mutates a new steady state child with the same chance each board has of
+  // being mutated in a generation, more than once if the rate is over 100%
 
-void Mutation::getRandCorner(int index[2])     // *Out*
-{ // Sets the 2 dimensional index for a random corner piece
+  double chance = mutNum / mutPopSize;   // Expected mutations of the child
+  int randNum = -1;                      // Random number to test chance
 
-  int cornerID = -1;        // For choosing random corner
+  while (chance >= 1.0)
+  { // Whole mutations are always applied
+    mutateOne(boardID);
+    chance -= 1.0;
+  }
 
-  // Generate a random number between 0 and 3 to randomly select which corner
-  GeneticAlgorithm::genRandomNum(0, 3, &cornerID);
+  GeneticAlgorithm::genRandomNum(0, 9999, &randNum);
 
-  if (cornerID == 0)
-  { // Set index to top left corner
-    index[0] = 0;
-    index[1] = 0;
+  if (randNum < chance * 10000)
+  { // Apply the remaining fraction as a chance of one more mutation
+    mutateOne(boardID);
   }
-  else if (cornerID == 1)
-  { // Set index to top right corner
-    index[0] = 0;
-    index[1] = BoardManager::getInstance()->getSize();
+
+} // mutateChild()
+
+
+void Mutation::mutateBoard(int boardID,        // *In*
+                           MutateType type)    // *In*
+{ // Calls the subroutine for the mutation method given on the board with the
+  // ID given
+
+  if (type == SWAP)   
+  { // If mutation method is swap, do swap
+    swap(boardID);
   }
-  else if (cornerID == 2)
-  { // Set index to bottom left corner
-    index[0] = BoardManager::getInstance()->getSize();
-    index[1] = 0;
+  else if (type == ROTATE)
+  { // If mutation rotate method is , do rotate
+    rotate(boardID);
   }
-  else
-  { // Set index to bottom right corner
-    index[0] = BoardManager::getInstance()->getSize();
-    index[1] = BoardManager::getInstance()->getSize();
+  else if (type == ROTATESWAP)
+  { // If mutation method is rotate & swap, do rotate & swap
+    rotateSwap(boardID);
+  }
+  else if (type == REGIONSWAP)
+  { // If mutation method is region swap, do region swap
+    regionSwap(boardID);
+  }
+  else if (type == REGIONROTATE)
+  {  // If mutation method is region rotate, do region rotate
+    regionRotate(boardID);
+  }
+  else if (type == GUIDEDSWAP)
+  { // If mutation method is guided swap, do guided swap
+    guidedSwap(boardID);
+  }
+  else if (type == REGIONMATCH)
+  { // If mutation method is region match, do region match
+    regionMatch(boardID);
+  }
+  else       
+  { // Mutation method not recognised, output error
+    std::cout << "Mutation method not recognised" << std::endl;
   }
 
-} // getRandCorner()
+} // mutateBoard()
 
 
-void Mutation::getRandEdge(int index[2])       // *Out*
-{ // Set the indexs in the array to two index taken from the top, right, left
-  // or bottom edges. The edge is randomly selected then select random piece
-  // from chosen edge
+MutateType Mutation::chooseOperator()
+{ // Chooses an operator for adaptive mode at random, weighted by the chance
+  // given to each operator by probability matching
 
-  int edgeID = -1;        // For choosing random edge
+  int randNum = -1;         // Random number to pick operator with
+  double spin = 0.0;        // Random point between 0 and 1
+  double total = 0.0;       // Running total of chances
 
-  // Generate a number to select which edge
-  GeneticAlgorithm::genRandomNum(0, 3, &edgeID);
+  GeneticAlgorithm::genRandomNum(0, 9999, &randNum);
+  spin = randNum / 10000.0;
 
-  if (edgeID == 0)
-  { // If mode is top edge set X index to 0 and gen random index between
-    // 1 and boardSize - 1 for Y index
-    index[0] = 0;
-    GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                   getSize() - 1, &index[1]);
+  for (int op = 0; op < ADAPTIVE; op++)
+  { // Add each operator's chance until the random point is passed
+    total += opProb[op];
+
+    if (spin < total)
+    {
+      return (MutateType)op;
+    }
   }
-  else if (edgeID == 1)
-  { // If mode is left edge gen random X index between 1 and boardsize -1
-    // and set Y index to 0
-    GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                   getSize() - 1, &index[0]);
-    index[1] = 0;
+
+  return (MutateType)(ADAPTIVE - 1);  // Rounding left point past the total
+
+} // chooseOperator()
+
+
+void Mutation::rewardOperator(MutateType type, // *In*
+                              int gain)        // *In*
+{ // Updates the recency weighted reward of the operator with the improvement
+  // in fitness it made, then rematches the chance of choosing each operator
+  // to its share of the total reward
+
+  double totalQuality = 0.0;    // Sum of reward of all operators
+
+  // Only improvements are rewarded, a worse board is the same as no change
+  opQuality[type] += ADAPTDECAY * (std::max(gain, 0) - opQuality[type]);
+
+  for (int op = 0; op < ADAPTIVE; op++)
+  {
+    totalQuality += opQuality[op];
   }
-  else if (edgeID == 2)
-  { // If mode is right edge gen random number between 1 and boardSize - 1
-    // and set Y index to boardSize
-    GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                   getSize() - 1, &index[0]);
-    index[1] = BoardManager::getInstance()->getSize();
+
+  for (int op = 0; op < ADAPTIVE; op++)
+  { // Every operator keeps a minimum chance so one that improves later in
+    // the run can still be found, the rest is shared out by reward
+    if (totalQuality > 0.0)
+    {
+      opProb[op] = ADAPTMINPROB + (1.0 - ADAPTIVE * ADAPTMINPROB) *
+                   (opQuality[op] / totalQuality);
+    }
+    else
+    {
+      opProb[op] = 1.0 / ADAPTIVE;
+    }
   }
-  else if (edgeID == 3)
-  { // If mode is bottom edge set X index to boardSize and gen random number
-    // between 1 and boardSize - 1 for Y index
-    index[0] = BoardManager::getInstance()->getSize();
-    GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                   getSize() - 1, &index[1]);
+
+} // rewardOperator()
+
+
+void Mutation::scramble(int boardID,           // *In*
+                        int moves)             // *In*
+{ // Applies the number of rotate & swap mutations given to the board, used to
+  // move a copy of a board far from the original when restarting
+
+  for (int i = 0; i < moves; i++)
+  { // Rotate & swap moves both inner and border pieces
+    rotateSwap(boardID);
   }
 
-} // genRandEdge()
+} // scramble()
+
 
+void Mutation::setStagnation(int stallCount)   // *In*
+{ // Raises the number of mutations per generation in adaptive mode as the
+  // generations without improvement build up, back to normal once improved
+
+  if (mutType == ADAPTIVE)
+  { // Scale linearly up to the peak rate once ADAPTSTALL generations pass
+    mutNum = baseMutNum * (1.0 + (ADAPTMAXRATE - 1.0) *
+             std::min(stallCount, ADAPTSTALL) / ADAPTSTALL);
+  }
 
-void Mutation::getRandInner(int index[2],      // *Out*
-                            bool startPiece,   // *In*
-                            bool region)       // *In*
-{ // Set the indexs in the array to two random number between 1 and the size
-    // of the board - 1 to get two inner type pieces
+} // setStagnation()
 
-  if (startPiece)
-  { // If starting piece constraint is active, make sure starting piece is not
-    // chosen as the random piece
 
-    do
-    { // Get a random piece index and loop while that index matches the start
-      // slot index
-      GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                     getSize() - 1, &index[0]);
-      GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                     getSize() - 1, &index[1]);
-    } while (index[0] == 8 && index[1] == 7);
+void Mutation::outputOperators()
+{ // Outputs the chance of each operator being chosen in adaptive mode
 
+  // Short names of operators for output, in order of MutateType
+  const char* names[ADAPTIVE] = { "Swap", "Rotate", "RotSwap", "RegSwap",
+                                  "RegRot", "Guided", "Match" };
+
+  if (mutType != ADAPTIVE)
+  { // Only adaptive mode has operator chances to show
+    return;
+  }
+
+  printf("Operators (%.0f per gen):", mutNum);
+
+  for (int op = 0; op < ADAPTIVE; op++)
+  {
+    printf(" %s %.0f%%", names[op], opProb[op] * 100.0);
+  }
+
+  printf("\n");
+
+} // outputOperators()
+
+
+void Mutation::calcMutRate(double rate,        // *In*
+                           int popSize)        // *In*
+{ // Calculates how many mutations to implement per generation
+
+  mutNum = (rate * popSize) / 100;    // See above
+  baseMutNum = mutNum;                // Rate to return to once improving
+
+} // calcMutRate()
+
+
+int Mutation::getRandPiece(int index[2],       // *Out*
+                           int type,           // *In*
+                           bool region,        // *In*
+                           int skip)           // *In*
+{ // Sets the 2 dimensional index for a random free slot with the type given
+  // as a parameter (0 = corner, 1 = edge, 2 = inner), or the top left slot of
+  // a free 2 x 2 inner region. Never picks the free slot numbered skip (-1 for
+  // any). Locked slots are not free so are never chosen. Returns the number
+  // of the free slot chosen
+
+  // Free slots or regions to choose from
+  std::vector<int>* slots = region ? boardMan->getFreeRegions() :
+                                     boardMan->getFreeSlots(type);
+  int choice = -1;                     // Free slot chosen
+
+  if (!region && !slotWeights.empty())
+  { // If mismatch bias is on, favour the slots that mismatch most
+    choice = getBiasedSlot(type, skip);
   }
-  else if (region)
-  { // If index is for region, generate index that does not include the right
-    // colum or bottom row of inner pieces
-    GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                   getSize() - 2, &index[0]);
-    GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                   getSize() - 2, &index[1]);
+  else if (skip < 0)
+  { // Any free slot can be chosen
+    GeneticAlgorithm::genRandomNum(0, (int)slots->size() - 1, &choice);
   }
   else
-  { // If start constraint is not active, just chose any random inner piece
-    GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                   getSize() - 1, &index[0]);
-    GeneticAlgorithm::genRandomNum(1, BoardManager::getInstance()->
-                                   getSize() - 1, &index[1]);
+  { // Choose from one fewer slots, stepping over the slot to skip
+    GeneticAlgorithm::genRandomNum(0, (int)slots->size() - 2, &choice);
+
+    if (choice >= skip)
+    {
+      choice++;
+    }
+  }
+
+  boardMan->getSlotIndex((*slots)[choice], index);
+
+  return choice;     // Return the number of the free slot chosen
+
+} // getRandPiece()
+
+
+int Mutation::getBiasedSlot(int type,          // *In*
+                            int skip)          // *In*
+{ // Chooses the number of a free slot of the type given with a chance in
+  // proportion to its weight, never picking the free slot numbered skip (-1
+  // for any)
+
+  std::vector<double>* totals = &slotWeights[type];  // Running weight totals
+  double skipWeight = 0.0;             // Weight of the slot to skip
+  double spin = 0.0;                   // Random point along the weights
+  int randNums[2] = { -1, -1 };        // Random numbers to make the spin
+
+  if (skip >= 0)
+  { // Take the weight of the slot to skip out of the wheel
+    skipWeight = (*totals)[skip] - (skip > 0 ? (*totals)[skip - 1] : 0.0);
+  }
+
+  // Two draws so the spin is fine enough for the number of slots on a board
+  GeneticAlgorithm::genRandomBatch(0, 9999, 2, randNums);
+  spin = ((randNums[0] * 10000.0 + randNums[1]) / 100000000.0) *
+         (totals->back() - skipWeight);
+
+  if (skip >= 0 && spin >= (*totals)[skip] - skipWeight)
+  { // Step over the slot to skip
+    spin += skipWeight;
+  }
+
+  // First slot whose running total passes the spin
+  int choice = (int)(std::upper_bound(totals->begin(), totals->end(), spin) -
+                     totals->begin());
+
+  return std::min(choice, (int)totals->size() - 1);  // Return slot chosen
+
+} // getBiasedSlot()
+
+
+void Mutation::loadHeatmap()
+{ // Weights each free slot by the mismatches of the slot in the heatmap of
+  // the board manager plus one, so random slots are drawn more often where
+  // the edges of the population do not match
+
+  std::vector<int>* heatmap = boardMan->getHeatmap();  // Mismatches per slot
+  double total = 0.0;                  // Running total of the weights
+
+  slotWeights.resize(3);
+
+  for (int type = CORNER; type <= INNER; type++)
+  { // Total the weights of the free slots of each type in list order
+
+    std::vector<int>* slots = boardMan->getFreeSlots(type);
+
+    slotWeights[type].resize(slots->size());
+    total = 0.0;
+
+    for (int i = 0; i < (int)slots->size(); i++)
+    { // Every slot keeps a small chance even if it always matches
+      total += heatmap->at((*slots)[i]) + 1.0;
+      slotWeights[type][i] = total;
+    }
   }
 
-} // genRandInner()
+} // loadHeatmap()
 
 
 void Mutation::swapPiece(int boardID,          // *In*
@@ -225,10 +386,20 @@ void Mutation::swapPiece(int boardID,          // *In*
   // also given as parameters
 
   // Create pointer to board to work with and initalise to point to board
-  Board* theBoard = &BoardManager::getInstance()->getPop()->at(boardID);
+  Board* theBoard = &boardMan->getPop()->at(boardID);
 
   // Temp puzzle piece to use during the swap
-  PuzzlePiece swapTemp = theBoard->boardVecs[pieceIndex1[0]][pieceIndex1[1]];
+  PackedPiece swapTemp = theBoard->boardVecs[pieceIndex1[0]][pieceIndex1[1]];
+
+  // Type of the pieces being swapped, looked up from the packed piece
+  PieceType pieceType = boardMan->getPiece(swapTemp.pieceID)->type;
+
+  noteSlot(theBoard, pieceIndex1);     // Note both slots before they change
+  noteSlot(theBoard, pieceIndex2);
+
+  // XOR both pieces out of the board hash before they move
+  theBoard->hash ^= getSlotKey(theBoard, pieceIndex1) ^
+                    getSlotKey(theBoard, pieceIndex2);
 
   // Place the second puzzle piece where first puzzle piece was located
   theBoard->boardVecs[pieceIndex1[0]][pieceIndex1[1]] =
@@ -237,72 +408,160 @@ void Mutation::swapPiece(int boardID,          // *In*
   // Place first puzzle piece back in second puzzle piece slot
   theBoard->boardVecs[pieceIndex2[0]][pieceIndex2[1]] = swapTemp;
 
-  if (swapTemp.type == EDGE || swapTemp.type == CORNER)
+  if (pieceType == EDGE || pieceType == CORNER)
   { // Make sure the pieces are roatetd correctly if mutation occured on a 
     // corner or edge piece
 
     // Rotate piece 1
-    BoardManager::getInstance()->fixOrien(&theBoard->boardVecs
-                                          [pieceIndex1[0]][pieceIndex1[1]], 
-                                          pieceIndex1[0], pieceIndex1[1]);
+    boardMan->fixOrien(&theBoard->boardVecs[pieceIndex1[0]][pieceIndex1[1]],
+                       pieceIndex1[0], pieceIndex1[1]);
 
     // Rotate piece 2
-    BoardManager::getInstance()->fixOrien(&theBoard->boardVecs[pieceIndex2[0]]
-      [pieceIndex2[1]], pieceIndex2[0],
-      pieceIndex2[1]);
+    boardMan->fixOrien(&theBoard->boardVecs[pieceIndex2[0]][pieceIndex2[1]],
+                       pieceIndex2[0], pieceIndex2[1]);
   }
 
+  // XOR both pieces back in to the board hash in their new slots
+  theBoard->hash ^= getSlotKey(theBoard, pieceIndex1) ^
+                    getSlotKey(theBoard, pieceIndex2);
+
 } // swapPiece()
 
 
+void Mutation::noteSlot(Board* theBoard,     // *In*
+                        int index[2])        // *In*
+{ // Notes the slot given and the piece it holds before it is changed, if the
+  // slot has not been noted already and an adaptive mutation is being scored
+
+  if (!isTouchNoted)
+  { // Nothing to note outside adaptive scoring
+    return;
+  }
+
+  for (int i = 0; i < touchCount; i++)
+  { // A slot changed twice keeps the piece it held first
+    if (touched[i][0] == index[0] && touched[i][1] == index[1])
+    {
+      return;
+    }
+  }
+
+  touched[touchCount][0] = index[0];
+  touched[touchCount][1] = index[1];
+  touchedPieces[touchCount] = theBoard->boardVecs[index[0]][index[1]];
+  touchCount++;
+
+} // noteSlot()
+
+
+int Mutation::scoreTouched(Board* theBoard)   // *In-Out*
+{ // Returns the change in fitness of the adaptive mutation just made, from
+  // the edges around the noted slots with the new pieces and then with the
+  // pieces they held before put back for the check
+
+  int newScore = 0;         // Score around the noted slots after
+  int oldScore = 0;         // Score around the noted slots before
+  int matches = 0;          // Matches, not needed for the reward
+  PackedPiece swapTemp;     // Piece moved out while the old one is checked
+
+  newScore = theFitness.checkLocal(theBoard, touched, touchCount, &matches);
+
+  for (int i = 0; i < touchCount; i++)
+  { // Put the old pieces back, keeping the new ones to restore after
+    swapTemp = theBoard->boardVecs[touched[i][0]][touched[i][1]];
+    theBoard->boardVecs[touched[i][0]][touched[i][1]] = touchedPieces[i];
+    touchedPieces[i] = swapTemp;
+  }
+
+  oldScore = theFitness.checkLocal(theBoard, touched, touchCount, &matches);
+
+  for (int i = 0; i < touchCount; i++)
+  { // Put the new pieces back in their slots
+    theBoard->boardVecs[touched[i][0]][touched[i][1]] = touchedPieces[i];
+  }
+
+  return newScore - oldScore;   // Return the change in fitness
+
+} // scoreTouched()
+
+
+unsigned long long Mutation::getSlotKey(Board* theBoard,     // *In*
+                                       int index[2])        // *In*
+{ // Returns the Zobrist key of the piece in the slot given with its current
+  // rotation
+
+  PackedPiece* piece = &theBoard->boardVecs[index[0]][index[1]];
+
+  return boardMan->getZobrist(index[0], index[1], piece->pieceID,
+                              piece->orientation);
+
+} // getSlotKey()
+
+
 void Mutation::rotatePiece(int boardID,        // *In*
                            int pieceIndex[2])  // *In*
 { // Rotates a piece 90 degrees clockwise, checks for orientation overflow.
   // Board and piece index given as parameters
 
-  if (BoardManager::getInstance()->getPop()->at(boardID).
+  // Create pointer to board to work with and initalise to point to board
+  Board* theBoard = &boardMan->getPop()->at(boardID);
+
+  noteSlot(theBoard, pieceIndex);      // Note the slot before it changes
+
+  // XOR the piece out of the board hash before it is rotated
+  theBoard->hash ^= getSlotKey(theBoard, pieceIndex);
+
+  if (boardMan->getPop()->at(boardID).
     boardVecs[pieceIndex[0]][pieceIndex[1]].orientation == 3)
   { // If the orientation is 1 rotation away from full 360 degree rotation
     // reset to original rotation
-    BoardManager::getInstance()->getPop()->at(boardID).
+    boardMan->getPop()->at(boardID).
       boardVecs[pieceIndex[0]][pieceIndex[1]].orientation = 0;
   }
   else
   { // If next rotation will not be original orientation, increment orientation
-    BoardManager::getInstance()->getPop()->at(boardID).
+    boardMan->getPop()->at(boardID).
       boardVecs[pieceIndex[0]][pieceIndex[1]].orientation++;
   }
 
+  // XOR the piece back in to the board hash with its new rotation
+  theBoard->hash ^= getSlotKey(theBoard, pieceIndex);
+
 } // rotatePiece()
 
 
-void Mutation::swap(int boardID,               // *In*
-                    bool startPiece)           // *In*
+void Mutation::swap(int boardID)               // *In*
 { // Swaps two random pieces in the board that has the ID given as the parameter
 
   int pieceIndex1[2] = { -1, -1 };     // Holds index of the first piece
   int pieceIndex2[2] = { -1, -1 };     // Holds index of second piece
+  int first = -1;                      // Number of the first free slot
 
   int pieceType = -1;                  // Holds random number for piece type
 
   // Get random piece type for mutation
   GeneticAlgorithm::genRandomNum(0, 2, &pieceType);
 
-  while (pieceIndex1[0] == pieceIndex2[0] && pieceIndex1[1] == pieceIndex2[1])
-  { // Get two random piece indexed of the generated type, making sure the
-    // indexes are not the same
-    getRandPiece(pieceIndex1, pieceType, startPiece, false);
-    getRandPiece(pieceIndex2, pieceType, startPiece, false);
-  } 
+  if (boardMan->getFreeSlots(pieceType)->size() < 2)
+  { // If fewer than two slots of the type are free, such as when the border
+    // is locked, swap inner pieces instead
+    pieceType = INNER;
+  }
+
+  if (boardMan->getFreeSlots(pieceType)->size() >= 2)
+  { // Get two different free slots of the generated type, the second never
+    // picks the first so the indexes are not the same
+    first = getRandPiece(pieceIndex1, pieceType, false, -1);
+    getRandPiece(pieceIndex2, pieceType, false, first);
 
-  // Call to swap the pieces with the index that have been generated
-  swapPiece(boardID, pieceIndex1, pieceIndex2);
+    // Call to swap the pieces with the index that have been generated
+    swapPiece(boardID, pieceIndex1, pieceIndex2);
+  }
 
 } // swap()
 
 
-void Mutation::rotate(int boardID,             // *In*
-                      bool startPiece)         // *In*
+void Mutation::rotate(int boardID)             // *In*
 { // Process the Rotate mutation method as described in chapter 3 of the report.
   // Generates a random index of a puzzle piece and rotates the piece 
   // orientation by 90 degrees clockwise. Calls to swap a different piece
@@ -311,23 +570,21 @@ void Mutation::rotate(int boardID,             // *In*
 
   int pieceIndex[2] = { -1, -1 };     // Holds the piece index to rotate
 
-  // Get a random piece index of type INNER without caring if the piece is the
-  // starting piece due to rotate not breaking the constraint. INNER not
-  // included due to border rotation already being managed
-  getRandPiece(pieceIndex, INNER, false, false);
+  // Get a random free piece index of type INNER, locked pieces keep their
+  // rotation. Border not included due to border rotation already being managed
+  getRandPiece(pieceIndex, INNER, false, -1);
 
   // Rotate the piece with the generated index within the given board
   rotatePiece(boardID, pieceIndex);
 
   // Call to swap a piece as rotate alone will not be enough to avoid a local
   // maxima or solve the puzzle
-  swap(boardID, startPiece);
+  swap(boardID);
 
 } // rotate()
 
 
-void Mutation::rotateSwap(int boardID,         // *In*
-                          bool startPiece)     // *In*
+void Mutation::rotateSwap(int boardID)         // *In*
 { // Process the Rotate & Swap mutation method as described in chapter 3 of the
   // report. Generates two random indexes of pieces within the board, rotates
   // clockwise 90 degress and swap the locations of the pieces Due to not being
@@ -336,32 +593,30 @@ void Mutation::rotateSwap(int boardID,         // *In*
 
   int pieceIndex1[2] = { -1, -1 };     // Holds index of first piece to mutate
   int pieceIndex2[2] = { -1, -1 };     // Holds index of second piece to mutate
+  int first = -1;                      // Number of the first free slot
 
-  while (pieceIndex1[0] == pieceIndex2[0] && pieceIndex1[1] == pieceIndex2[1])
-  { // Get a random piece index of type INNER without caring if the piece is the
-    // starting piece due to rotate not breaking the constraint. INNER not
-    // included due to border rotation already being managed. Makes sure pieces
-    // are not the same
-    getRandPiece(pieceIndex1, INNER, startPiece, false);
-    getRandPiece(pieceIndex2, INNER, startPiece, false);
-  } 
+  if (boardMan->getFreeSlots(INNER)->size() >= 2)
+  { // Get two different free piece indexes of type INNER. Border not included
+    // due to border rotation already being managed
+    first = getRandPiece(pieceIndex1, INNER, false, -1);
+    getRandPiece(pieceIndex2, INNER, false, first);
 
-  // Call to rotate both pieces
-  rotatePiece(boardID, pieceIndex1);
-  rotatePiece(boardID, pieceIndex2);
+    // Call to rotate both pieces
+    rotatePiece(boardID, pieceIndex1);
+    rotatePiece(boardID, pieceIndex2);
 
-  // Call to swap the locations of the pieces
-  swapPiece(boardID, pieceIndex1, pieceIndex2);
+    // Call to swap the locations of the pieces
+    swapPiece(boardID, pieceIndex1, pieceIndex2);
+  }
 
   // Call to swap a piece as rotate alone will not be enough to avoid a local
   // maxima or solve the puzzle
-  swap(boardID, startPiece);
+  swap(boardID);
 
 } // rotateSwap()
 
 
-void Mutation::regionRotate(int boardID,       // *In*
-                            bool startPiece)   // *In*
+void Mutation::regionRotate(int boardID)       // *In*
 { // Process the Region Rotate mutation method as described in chapter 3 of
   // report. Generates a random index of a puzzle piece to use as the top left
   // piece of a 2 x 2 region. Rotates the entire 2 x 2 region 90 degrees
@@ -370,35 +625,36 @@ void Mutation::regionRotate(int boardID,       // *In*
 
   int regionIndex[2] = { -1, -1 };      // Holds top left index of region
 
-  // Generate a random index for the top right of the region, making sure the
-  // index is not on the right coloum or bottom row of inner edges. Set region
-  // mode for generating index to true
-  getRandPiece(regionIndex, INNER, false, true);
+  if (!boardMan->getFreeRegions()->empty())
+  { // Generate a random index for the top left of a region with no locked
+    // slot, the free regions never start on the right coloum or bottom row of
+    // inner edges. Set region mode for generating index to true
+    getRandPiece(regionIndex, INNER, true, -1);
 
-  // Rotate top left piece of region
-  rotatePiece(boardID, regionIndex);
+    // Rotate top left piece of region
+    rotatePiece(boardID, regionIndex);
 
-  // Set region index to top right of region and rotate
-  regionIndex[0]++;
-  rotatePiece(boardID, regionIndex);
+    // Set region index to top right of region and rotate
+    regionIndex[0]++;
+    rotatePiece(boardID, regionIndex);
 
-  // Set region index to bottom right of region and rotate
-  regionIndex[1]++;
-  rotatePiece(boardID, regionIndex);
+    // Set region index to bottom right of region and rotate
+    regionIndex[1]++;
+    rotatePiece(boardID, regionIndex);
 
-  // Set region index to bottom left of region and rotate
-  regionIndex[0]--;
-  rotatePiece(boardID, regionIndex);
+    // Set region index to bottom left of region and rotate
+    regionIndex[0]--;
+    rotatePiece(boardID, regionIndex);
+  }
 
   // Call to swap a piece as rotate alone will not be enough to avoid a local
   // maxima or solve the puzzle
-  swap(boardID, startPiece);
+  swap(boardID);
 
 } // regionRotate()
 
 
-void Mutation::regionSwap(int boardID,         // *In*
-                          bool startPiece)     // *In*
+void Mutation::regionSwap(int boardID)         // *In*
 { // Process the Region Swap mutation method as described in chapter 3 of the
   // report. Generates two random indexes which will be used as the top left
   // pieces of two 2 x 2 regions then swaps locations of regions. 1 piece swap
@@ -406,35 +662,229 @@ void Mutation::regionSwap(int boardID,         // *In*
 
   int regionIndex1[2] = { -1, -1 };    // Holds top left index of first region
   int regionIndex2[2] = { -1, -1 };    // Holds top left index of second region
+  int first = -1;                      // Number of the first free region
+
+  if (boardMan->getFreeRegions()->size() >= 2)
+  { // Generate the top left indexes of two different regions with no locked
+    // slot, the second never picks the first
+    first = getRandPiece(regionIndex1, INNER, true, -1);
+    getRandPiece(regionIndex2, INNER, true, first);
+
+    // Swap the top left region pieces
+    swapPiece(boardID, regionIndex1, regionIndex2);
+
+    // Set region indexes to top right of regions and swap
+    regionIndex1[0]++;
+    regionIndex2[0]++;
+    swapPiece(boardID, regionIndex1, regionIndex2);
+
+    // Set region indexes to bottom right of regions and swap
+    regionIndex1[1]++;
+    regionIndex2[1]++;
+    swapPiece(boardID, regionIndex1, regionIndex2);
+
+    // Set region indexes to bottom left of regions and swap
+    regionIndex1[0]--;
+    regionIndex2[0]--;
+    swapPiece(boardID, regionIndex1, regionIndex2);
+  }
 
-  while (regionIndex1[0] == regionIndex2[0] && 
-         regionIndex1[1] == regionIndex2[1])
-  { // Generate the top left indexes of two regions, repeat to make sure they
-    // are two different indexes
-    getRandPiece(regionIndex1, INNER, startPiece, true);
-    getRandPiece(regionIndex2, INNER, startPiece, true);
+  // Call to swap a piece as rotate alone will not be enough to avoid a local
+  // maxima or solve the puzzle
+  swap(boardID);
+
+} // regionSwap()
+
+
+bool Mutation::isMismatched(Board* theBoard,          // *In*
+                            int index[2])             // *In*
+{ // Returns whether any edge of the piece in the slot given does not match
+  // the piece next to it
+
+  bool result = false;                                  // Holds if mismatched
+
+  if (index[0] > 0 && boardMan->getPattern(theBoard, index[0], index[1], LEFT)
+      != boardMan->getPattern(theBoard, index[0] - 1, index[1], RIGHT))
+  { // If piece does not match the piece to the left
+    result = true;
+  }
+  else if (index[1] > 0 && boardMan->getPattern(theBoard, index[0], index[1],
+           TOP) != boardMan->getPattern(theBoard, index[0], index[1] - 1,
+           BOTTOM))
+  { // If piece does not match the piece above
+    result = true;
+  }
+  else if (index[0] < boardMan->getSize() && boardMan->getPattern(theBoard,
+           index[0], index[1], RIGHT) != boardMan->getPattern(theBoard,
+           index[0] + 1, index[1], LEFT))
+  { // If piece does not match the piece to the right
+    result = true;
+  }
+  else if (index[1] < boardMan->getSize() && boardMan->getPattern(theBoard,
+           index[0], index[1], BOTTOM) != boardMan->getPattern(theBoard,
+           index[0], index[1] + 1, TOP))
+  { // If piece does not match the piece below
+    result = true;
   }
 
-  // Swap the top left region pieces
-  swapPiece(boardID, regionIndex1, regionIndex2);
+  return result;      // Return whether the piece is mismatched
 
-  // Set region indexes to top right of regions and swap
-  regionIndex1[0]++;
-  regionIndex2[0]++;
-  swapPiece(boardID, regionIndex1, regionIndex2);
+} // isMismatched()
 
-  // Set region indexes to bottom right of regions and swap
-  regionIndex1[1]++;
-  regionIndex2[1]++;
-  swapPiece(boardID, regionIndex1, regionIndex2);
 
-  // Set region indexes to bottom left of regions and swap
-  regionIndex1[0]--;
-  regionIndex2[0]--;
-  swapPiece(boardID, regionIndex1, regionIndex2);
+bool Mutation::findPiece(Board* theBoard,             // *In*
+                         int pieceID,                 // *In*
+                         int type,                    // *In*
+                         int index[2])                // *Out*
+{ // Finds the slot holding the piece with the ID given, searching only slots
+  // of the piece type given. Returns whether the piece was found
 
-  // Call to swap a piece as rotate alone will not be enough to avoid a local
-  // maxima or solve the puzzle
-  swap(boardID, startPiece);
+  bool isFound = false;                              // Holds if piece found
+  int size = boardMan->getSize();   // Last index of board
 
-} // regionSwap()
+  for (int i = 0; i <= size && !isFound; i++)
+  { // X index of slot to check
+    for (int j = 0; j <= size && !isFound; j++)
+    { // Y index of slot to check
+
+      if (type == boardMan->getSlotType(i, j) &&
+          theBoard->boardVecs[i][j].pieceID == pieceID)
+      { // If slot is of the right type and holds the piece, store index
+        index[0] = i;
+        index[1] = j;
+        isFound = true;
+      }
+    }
+  }
+
+  return isFound;     // Return whether piece was found
+
+} // findPiece()
+
+
+void Mutation::guidedSwap(int boardID)                // *In*
+{ // Process the Guided Swap mutation method. Finds a slot with a mismatched
+  // edge then uses the colour index to pull in a piece whose rotation matches
+  // the pieces to the left and above. Falls back to swap if no slot or piece
+  // is found
+
+  // Create pointer to board to work with and initalise to point to board
+  Board* theBoard = &boardMan->getPop()->at(boardID);
+
+  int slotIndex[2] = { -1, -1 };    // Holds index of mismatched slot
+  int pieceIndex[2] = { -1, -1 };   // Holds index of piece to pull in
+  int pieceType = -1;               // Holds random number for piece type
+  int left = 0;                     // Colour needed on left of piece
+  int top = 0;                      // Colour needed on top of piece
+  int choice = -1;                  // Holds random candidate to use
+  bool isDone = false;              // Holds if a guided swap was made
+  PackedPiece rotated;              // Candidate rotated for its new slot
+
+  std::vector<PieceRef>* matches = nullptr;   // Pieces matching the colours
+  std::vector<PieceRef> candidates;           // Matches that can be used
+
+  for (int i = 0; i < GUIDEDTRIES && !isDone; i++)
+  { // Try a few random slots to find one with a mismatched edge
+
+    // Get random piece type then random free slot of that type
+    GeneticAlgorithm::genRandomNum(0, 2, &pieceType);
+
+    if (boardMan->getFreeSlots(pieceType)->size() < 2)
+    { // If no piece of the type can be pulled in, such as when the border is
+      // locked, use inner pieces instead
+      pieceType = INNER;
+    }
+
+    if (boardMan->getFreeSlots(pieceType)->size() < 2)
+    { // If no inner piece can be pulled in either, try again
+      continue;
+    }
+
+    getRandPiece(slotIndex, pieceType, false, -1);
+
+    if (!isMismatched(theBoard, slotIndex))
+    { // If the slot already matches, try again
+      continue;
+    }
+
+    // Colour the piece to the left and above show towards the slot, the
+    // edge colour for slots on the top or left edges
+    left = (slotIndex[0] > 0) ? boardMan->getPattern(
+             theBoard, slotIndex[0] - 1, slotIndex[1], RIGHT) :
+             boardMan->getEdgeColour();
+    top = (slotIndex[1] > 0) ? boardMan->getPattern(
+            theBoard, slotIndex[0], slotIndex[1] - 1, BOTTOM) :
+            boardMan->getEdgeColour();
+
+    matches = boardMan->getColourMatches(pieceType, left, top);
+    candidates.clear();
+
+    // Work out the rotation the slot forces on border pieces
+    rotated = theBoard->boardVecs[slotIndex[0]][slotIndex[1]];
+    boardMan->fixOrien(&rotated, slotIndex[0], slotIndex[1]);
+
+    for (int j = 0; matches != nullptr && j < (int)matches->size(); j++)
+    { // Keep matches that are not already in the slot, not locked and for
+      // border pieces have the rotation the slot forces
+
+      if ((*matches)[j].pieceID != 
+          theBoard->boardVecs[slotIndex[0]][slotIndex[1]].pieceID &&
+          !boardMan->isPieceLocked((*matches)[j].pieceID) &&
+          (pieceType == INNER || 
+           (*matches)[j].orientation == rotated.orientation))
+      {
+        candidates.push_back((*matches)[j]);
+      }
+    }
+
+    if (!candidates.empty())
+    { // If a piece can be pulled in, swap it in to the slot and rotate it
+
+      GeneticAlgorithm::genRandomNum(0, (int)candidates.size() - 1, &choice);
+
+      if (findPiece(theBoard, candidates[choice].pieceID, pieceType,
+                    pieceIndex))
+      { // Swap the pieces, fixing border rotations, then rotate inner piece
+        swapPiece(boardID, slotIndex, pieceIndex);
+
+        if (pieceType == INNER)
+        { // Border pieces already rotated by swap, keep hash up to date
+          theBoard->hash ^= getSlotKey(theBoard, slotIndex);
+          theBoard->boardVecs[slotIndex[0]][slotIndex[1]].orientation =
+            candidates[choice].orientation;
+          theBoard->hash ^= getSlotKey(theBoard, slotIndex);
+        }
+
+        isDone = true;
+      }
+    }
+  } // for i < GUIDEDTRIES
+
+  if (!isDone)
+  { // If no guided swap could be made, do a normal swap
+    swap(boardID);
+  }
+
+} // guidedSwap()
+
+
+void Mutation::regionMatch(int boardID)               // *In*
+{ // Process the Region Match mutation method. Frees every other slot of a
+  // random row, column or square of inner slots and puts the freed pieces
+  // back in the best arrangement against the pieces around them. 1 piece swap
+  // is also called so that the border has a chance of mutation
+
+  int shape = -1;         // Holds random shape of region to free
+  int matchDelta = 0;     // Change in matches, not needed by mutation
+
+  // Get random shape of region
+  GeneticAlgorithm::genRandomNum(MATCHROW, MATCHREGION, &shape);
+
+  // Reassign the region within the board, the matcher scores its own change
+  touchGain += theMatcher.improve(&boardMan->getPop()->at(boardID),
+                                  (RegionShape)shape, &matchDelta);
+
+  // Call to swap a piece as the reassignment never touches the border
+  swap(boardID);
+
+} // regionMatch()
\ No newline at end of file
@@ -8,11 +8,23 @@
 
 
 #include "BoardManager.h"    // PieceType, access to population, board size
+#include "RegionMatcher.h"   // Optimal reassignment of freed regions
+#include "FitnessFunction.h" // Scoring operators in adaptive mode
+#include <vector>            // Operator quality and probabilities
 
 
 // Holds all of the different mutation methods that can be used
 enum MutateType { SWAP, ROTATE, ROTATESWAP, REGIONSWAP, REGIONROTATE, 
-                  MUTDEFAULT};
+                  GUIDEDSWAP, REGIONMATCH, ADAPTIVE, MUTDEFAULT};
+
+
+#define GUIDEDTRIES 8        // Slots tried by guided swap to find a mismatch
+#define ADAPTMINPROB 0.05    // Lowest chance of any operator being chosen
+#define ADAPTDECAY   0.1     // Weight given to the newest reward of operator
+#define ADAPTSTALL   200     // Generations without improvement for peak rate
+#define ADAPTMAXRATE 4.0     // Mutation rate multiplier at peak stagnation
+#define TOUCHMAX     16      // Slots one mutation can change, region swap
+                             // with its extra swap changes the most at 10
 
 
 class Mutation
@@ -21,31 +33,55 @@ class Mutation
 private:
   MutateType mutType;                  // Holds method of mutation
   double mutNum;                       // Number to mutate per generation 
+  double baseMutNum;                   // Number to mutate when not stuck
+  int mutPopSize;                      // Number of boards in the population
+  BoardManager* boardMan;              // Board manager of the solver
+  RegionMatcher theMatcher;            // Reassigns freed regions optimally
+  FitnessFunction theFitness;          // Scores operators in adaptive mode
+  std::vector<double> opQuality;       // Recency weighted reward of operators
+  std::vector<double> opProb;          // Chance of each operator being chosen
+
+  // Slots changed by the adaptive mutation being scored and the piece each
+  // held before, so the reward is scored from the edges around them alone
+  int touched[TOUCHMAX][2];
+  PackedPiece touchedPieces[TOUCHMAX];
+  int touchCount;                      // Slots noted in touched
+  int touchGain;                       // Gain already scored by the operator
+  bool isTouchNoted;                   // Whether changed slots are noted
+
+  // Running total of the mismatch weight of the free slots of each type, in
+  // the order of the free slot lists. Empty unless mismatch bias is on
+  std::vector<std::vector<double>> slotWeights;
 
   // Calculates how many mutations to implement per generation
   void calcMutRate(double rate,        // *In*
                    int popSize);       // *In*
 
-  // Sets the 2 dimensional index for a random piece with the type given
-  // as a parameter (0 = corner, 1 = edge, 2 = inner)
-  void getRandPiece(int index[2],      // *Out*
-                    int type,          // *In*
-                    bool startPiece,   // *In*
-                    bool region);      // *In*
-
-  // Sets the 2 dimensional index for a random corner piece
-  void getRandCorner(int index[2]);    // *Out*
-
-  // Set the indexs in the array to two index taken from the top, right, left
-  // or bottom edges. The edge is randomly selected then select random piece
-  // from chosen edge
-  void getRandEdge(int index[2]);      // *Out*
-
-  // Set the indexs in the array to two random number between 1 and the size
-  // of the board - 1 to get two inner type pieces
-  void getRandInner(int index[2],      // *Out*
-                    bool startPiece,   // *In*
-                    bool region);      // *In*
+  // Sets the 2 dimensional index for a random free slot with the type given
+  // as a parameter (0 = corner, 1 = edge, 2 = inner), or the top left slot of
+  // a free 2 x 2 inner region. Never picks the free slot numbered skip (-1 for
+  // any). Locked slots are not free so are never chosen. Returns the number
+  // of the free slot chosen
+  int getRandPiece(int index[2],       // *Out*
+                   int type,           // *In*
+                   bool region,        // *In*
+                   int skip);          // *In*
+
+  // Chooses the number of a free slot of the type given with a chance in
+  // proportion to its weight, never picking the free slot numbered skip (-1
+  // for any)
+  int getBiasedSlot(int type,          // *In*
+                    int skip);         // *In*
+
+  // Notes the slot given and the piece it holds before it is changed, if the
+  // slot has not been noted already and an adaptive mutation is being scored
+  void noteSlot(Board* theBoard,       // *In*
+                int index[2]);         // *In*
+
+  // Returns the change in fitness of the adaptive mutation just made, from
+  // the edges around the noted slots with the new pieces and then with the
+  // pieces they held before put back for the check
+  int scoreTouched(Board* theBoard);   // *In-Out*
 
   // Swaps two pieces within the board with the ID given. Pieces to swap
   // also given as parameters
@@ -53,6 +89,11 @@ private:
                  int pieceIndex1[2],   // *In*
                  int pieceIndex2[2]);  // *In*
 
+  // Returns the Zobrist key of the piece in the slot given with its current
+  // rotation
+  unsigned long long getSlotKey(Board* theBoard, // *In*
+                                int index[2]);   // *In*
+
   // Rotates a piece 90 degrees clockwise, checks for orientation overflow.
   // Board and piece index given as parameters
   void rotatePiece(int boardID,        // *In*
@@ -60,43 +101,77 @@ private:
 
   // Process the Swap mutation method as described in chapter 3 of the report.
   // Swaps two random pieces in the board that has the ID given as the parameter
-  void swap(int boardID,               // *In*
-            bool startPiece);          // *In*
+  void swap(int boardID);              // *In*
 
   // Process the Rotate mutation method as described in chapter 3 of the report.
   // Generates a random index of a puzzle piece and rotates the piece 
   // orientation by 90 degrees clockwise. Calls to swap a different piece
   // as rotate by itself would not solve a puzzle Different to rotate and swap 
   // as different pieces recieve the swap to the rotate
-  void rotate(int boardID,             // *In*
-              bool startPiece);        // *In*
+  void rotate(int boardID);            // *In*
 
   // Process the Rotate & Swap mutation method as described in chapter 3 of the
   // report. Generates two random indexes of pieces within the board, rotates
   // clockwise 90 degress and swap the locations of the pieces Due to not being
   // able to rotate the border, swapping a different piece is called to let
   // the border be mutated. 
-  void rotateSwap(int boardID,         // *In*
-                  bool startPiece);    // *In*
+  void rotateSwap(int boardID);        // *In*
 
   // Process the Region Rotate mutation method as described in chapter 3 of
   // report. Generates a random index of a puzzle piece to use as the top left
   // piece of a 2 x 2 region. Rotates the entire 2 x 2 region 90 degrees
   // clockwise. Swap is also called as rotating alone will not solve. Different
   // to rotate and swap as different pieces recieve the swap to the rotate
-  void regionRotate(int boardID,       // *In*
-                    bool startPiece);  // *In*
+  void regionRotate(int boardID);      // *In*
 
   // Process the Region Swap mutation method as described in chapter 3 of the
   // report. Generates two random indexes which will be used as the top left
   // pieces of two 2 x 2 regions then swaps locations of regions. 1 piece swap
   // is also called so that the border has a chance of mutation
-  void regionSwap(int boardID,         // *In*
-                  bool startPiece);    // *In*
+  void regionSwap(int boardID);        // *In*
+
+  // Returns whether any edge of the piece in the slot given does not match
+  // the piece next to it
+  bool isMismatched(Board* theBoard,   // *In*
+                    int index[2]);     // *In*
+
+  // Finds the slot holding the piece with the ID given, searching only slots
+  // of the piece type given. Returns whether the piece was found
+  bool findPiece(Board* theBoard,      // *In*
+                 int pieceID,          // *In*
+                 int type,             // *In*
+                 int index[2]);        // *Out*
+
+  // Process the Guided Swap mutation method. Finds a slot with a mismatched
+  // edge then uses the colour index to pull in a piece whose rotation matches
+  // the pieces to the left and above. Falls back to swap if no slot or piece
+  // is found
+  void guidedSwap(int boardID);        // *In*
+
+  // Process the Region Match mutation method. Frees every other slot of a
+  // random row, column or square of inner slots and puts the freed pieces
+  // back in the best arrangement against the pieces around them. 1 piece swap
+  // is also called so that the border has a chance of mutation
+  void regionMatch(int boardID);       // *In*
+
+  // Calls the subroutine for the mutation method given on the board with the
+  // ID given
+  void mutateBoard(int boardID,        // *In*
+                   MutateType type);   // *In*
+
+  // Chooses an operator for adaptive mode at random, weighted by the chance
+  // given to each operator by probability matching
+  MutateType chooseOperator();
+
+  // Updates the recency weighted reward of the operator with the improvement
+  // in fitness it made, then rematches the chance of choosing each operator
+  // to its share of the total reward
+  void rewardOperator(MutateType type, // *In*
+                      int gain);       // *In*
 
 public:
-  // Initialise mutation method
-  Mutation();
+  // Initialise mutation method and store the board manager of the solver
+  Mutation(BoardManager* manager);     // *In*
 
   // Sets the method of mutation to use for this attempt
   void setup(MutateType type,          // *In*
@@ -106,7 +181,32 @@ public:
   // Randomly selects a board from the current population to be mutated
   // then calls the appropriate subroutine that will do the needed mutation
   // method on that board.
-  void doMutation(bool startPiece);    // *In*
+  void doMutation();
+
+  // Applies one mutation to the board with the ID given, using the mutation
+  // method set or an operator chosen by adaptive mode
+  void mutateOne(int boardID);         // *In*
+
+  // Mutates a new steady state child with the same chance each board has of
+  // being mutated in a generation, more than once if the rate is over 100%
+  void mutateChild(int boardID);       // *In*
+
+  // Applies the number of rotate & swap mutations given to the board, used to
+  // move a copy of a board far from the original when restarting
+  void scramble(int boardID,           // *In*
+                int moves);            // *In*
+
+  // Raises the number of mutations per generation in adaptive mode as the
+  // generations without improvement build up, back to normal once improved
+  void setStagnation(int stallCount);  // *In*
+
+  // Weights each free slot by the mismatches of the slot in the heatmap of
+  // the board manager plus one, so random slots are drawn more often where
+  // the edges of the population do not match
+  void loadHeatmap();
+
+  // Outputs the chance of each operator being chosen in adaptive mode
+  void outputOperators();
 
 }; // Mutation
 
@@ -0,0 +1,219 @@
+// Title        : PuzzleGenerator.cpp
+// Purpose      : Generates seeded corpora of solvable puzzles in parallel
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#include "PuzzleGenerator.h"    // Class declaration
+#include <algorithm>            // min(), max(), swap(), rotate()
+#include <thread>               // Generating threads
+
+
+void PuzzleGenerator::generateSet(int size,                 // *In*
+                                  int patternNum,           // *In*
+                                  int count,                // *In*
+                                  int seed,                 // *In*
+                                  bool isOfficialStyle,     // *In*
+                                  std::vector<GeneratedPuzzle>* puzzles)
+{ // Generates count puzzles of the size and pattern count given split across
+  // every hardware thread. Each puzzle is seeded from the corpus seed, size,
+  // pattern count and its index, so the set is the same on any thread count
+
+  std::vector<std::thread> threads; // Running generating threads
+  int threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+  int share = (count + threadCount - 1) / threadCount;  // Puzzles per thread
+  int first = 0;                    // First puzzle of a thread
+
+  puzzles->assign(count, GeneratedPuzzle());
+
+  for (int i = 0; i < count; i++)
+  { // Work out the seed of each puzzle before any thread starts
+    std::seed_seq sequence{ (unsigned int)seed, (unsigned int)size,
+                            (unsigned int)patternNum, (unsigned int)i };
+
+    (*puzzles)[i].size = size;
+    (*puzzles)[i].patternNum = patternNum;
+    (*puzzles)[i].index = i;
+    sequence.generate(&(*puzzles)[i].seed, &(*puzzles)[i].seed + 1);
+  }
+
+  for (int i = 0; i < threadCount; i++)
+  { // Give each thread its own range of puzzles
+
+    first = i * share;
+
+    if (first < count)
+    {
+      threads.push_back(std::thread(&PuzzleGenerator::generateRange, this,
+                                    puzzles, first,
+                                    std::min(first + share, count),
+                                    isOfficialStyle));
+    }
+  }
+
+  for (std::thread& thread : threads)
+  { // Wait for every thread to finish its puzzles
+    thread.join();
+  }
+
+} // generateSet()
+
+
+void PuzzleGenerator::generateRange(
+  std::vector<GeneratedPuzzle>* puzzles,                    // *In-Out*
+  int first,                                                // *In*
+  int last,                                                 // *In*
+  bool isOfficialStyle)                                     // *In*
+{ // Generates the puzzles given from the first index given up to but not
+  // including the last index given
+
+  for (int i = first; i < last; i++)
+  { // Generate each puzzle of the range from its own seed
+    generate(&(*puzzles)[i], isOfficialStyle);
+  }
+
+} // generateRange()
+
+
+void PuzzleGenerator::fillJoins(std::vector<int*>* joins,   // *In-Out*
+                                int low,                    // *In*
+                                int high,                   // *In*
+                                bool isOfficialStyle,       // *In*
+                                std::mt19937* generator)    // *In-Out*
+{ // Fills the colours of the joins given with the colours from low to high.
+  // Official style spreads the colours evenly then shuffles them, otherwise
+  // each is drawn at random
+
+  int range = high - low + 1;       // Colours to choose from
+
+  for (int i = 0; i < (int)joins->size(); i++)
+  { // Give each join a colour
+    *(*joins)[i] = isOfficialStyle ? low + i % range :
+                                     low + getRandom(generator, range);
+  }
+
+  if (isOfficialStyle)
+  { // Shuffle the even spread of colours over the joins
+    for (int i = (int)joins->size() - 1; i > 0; i--)
+    {
+      std::swap(*(*joins)[i], *(*joins)[getRandom(generator, i + 1)]);
+    }
+  }
+
+} // fillJoins()
+
+
+void PuzzleGenerator::generate(GeneratedPuzzle* puzzle,     // *In-Out*
+                               bool isOfficialStyle)        // *In*
+{ // Generates the pieces of one puzzle from its size, pattern count and seed.
+  // A colour is drawn for every join between two slots, each piece takes the
+  // colours of the joins around it, border pieces are turned so their edge is
+  // at the bottom, inner pieces are turned at random and the pieces of each
+  // type are shuffled so IDs give nothing away
+
+  std::mt19937 generator(puzzle->seed);  // Random numbers of the puzzle
+  int size = puzzle->size;          // How many rows/cols are on the board
+  int last = size - 1;              // Last index of board
+  int borderColours = puzzle->patternNum;  // Colours of the border joins
+  int turns = 0;                    // Quarter turns of an inner piece
+  int pieceID = 1;                  // Next piece ID
+
+  // Colour of the join to the right of each slot, indexed x * size + y
+  std::vector<int> across((size_t)size * size, 0);
+
+  // Colour of the join below each slot, indexed x * size + y
+  std::vector<int> down((size_t)size * size, 0);
+
+  std::vector<int*> borderJoins;    // Joins between two border slots
+  std::vector<int*> innerJoins;     // Every other join
+  PuzzlePiece piece;                // Piece being made
+
+  for (int x = 0; x < size; x++)
+  { // Sort every join by whether it runs along the border
+    for (int y = 0; y < size; y++)
+    {
+      if (x < last)
+      { // Join to the right runs along the border on the top and bottom rows
+        ((y == 0 || y == last) ? borderJoins : innerJoins).push_back(
+          &across[x * size + y]);
+      }
+
+      if (y < last)
+      { // Join below runs along the border on the left and right columns
+        ((x == 0 || x == last) ? borderJoins : innerJoins).push_back(
+          &down[x * size + y]);
+      }
+    }
+  }
+
+  if (isOfficialStyle && puzzle->patternNum > 1)
+  { // The official puzzle keeps 5 of its 22 colours for joins between border
+    // pieces, keep the same share of the colours given
+    borderColours = (puzzle->patternNum * OFFICIALBORDER +
+                     OFFICIALPATTERNS / 2) / OFFICIALPATTERNS;
+    borderColours = std::max(1, std::min(borderColours,
+                                         puzzle->patternNum - 1));
+
+    fillJoins(&borderJoins, 1, borderColours, true, &generator);
+    fillJoins(&innerJoins, borderColours + 1, puzzle->patternNum, true,
+              &generator);
+  }
+  else
+  { // Every join can take any colour
+    fillJoins(&borderJoins, 1, puzzle->patternNum, false, &generator);
+    fillJoins(&innerJoins, 1, puzzle->patternNum, false, &generator);
+  }
+
+  puzzle->pieces.assign(3, std::vector<PuzzlePiece>());
+
+  for (int y = 0; y < size; y++)
+  { // Make the piece of each slot from the joins around it
+    for (int x = 0; x < size; x++)
+    {
+      piece.orientation = 0;
+      piece.segments[TOP] = (y > 0) ? down[x * size + y - 1] : 0;
+      piece.segments[RIGHT] = (x < last) ? across[x * size + y] : 0;
+      piece.segments[BOTTOM] = (y < last) ? down[x * size + y] : 0;
+      piece.segments[LEFT] = (x > 0) ? across[(x - 1) * size + y] : 0;
+
+      piece.type = ((x == 0 || x == last) && (y == 0 || y == last)) ? CORNER :
+                   (x == 0 || x == last || y == 0 || y == last) ? EDGE :
+                   INNER;
+
+      // Border pieces are stored with their edge at the bottom, and corners
+      // with their second edge on the left, inner pieces at any turn
+      turns = (piece.type == INNER) ? getRandom(&generator, 4) : 4;
+
+      for (int t = 0; t < turns; t++)
+      { // Turn the piece a quarter at a time until it rests as stored
+
+        if (piece.type != INNER && piece.segments[BOTTOM] == 0 &&
+            (piece.type == EDGE || piece.segments[LEFT] == 0))
+        {
+          break;
+        }
+
+        std::rotate(piece.segments, piece.segments + 1, piece.segments + 4);
+      }
+
+      puzzle->pieces[piece.type].push_back(piece);
+    }
+  }
+
+  for (int type = CORNER; type <= INNER; type++)
+  { // Shuffle the pieces of each type then number them in file order
+
+    std::vector<PuzzlePiece>* pieces = &puzzle->pieces[type];
+
+    for (int i = (int)pieces->size() - 1; i > 0; i--)
+    {
+      std::swap((*pieces)[i], (*pieces)[getRandom(&generator, i + 1)]);
+    }
+
+    for (PuzzlePiece& next : *pieces)
+    {
+      next.pieceID = pieceID++;
+    }
+  }
+
+} // generate()
\ No newline at end of file
@@ -0,0 +1,95 @@
+// Title        : PuzzleGenerator.h
+// Purpose      : Generates seeded corpora of solvable puzzles in parallel
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#define OFFICIALBORDER   5      // Border colours of the official puzzle
+#define OFFICIALPATTERNS 22     // Colours of the official puzzle
+
+
+#include "BoardManager.h"       // Puzzle piece definition
+#include <vector>               // Pieces, joins and puzzles
+#include <random>               // Random numbers of each puzzle
+
+
+struct GeneratorSettings
+{ // Holds the settings read from the generator file for one corpus
+
+  int minSize;                    // Smallest board size generated
+  int maxSize;                    // Largest board size generated
+  int minPatterns;                // Fewest patterns generated
+  int maxPatterns;                // Most patterns generated
+  int puzzleCount;                // Puzzles of each size and pattern count
+  int seed;                       // Seed the whole corpus is made from
+  bool isOfficialStyle;           // Whether colours mimic the official puzzle
+  bool isBinary;                  // Whether a binary file is also written
+
+}; // GeneratorSettings
+
+
+struct GeneratedPuzzle
+{ // Holds one generated puzzle and what it was made from, so it can be made
+  // again from the manifest
+
+  int size;                       // How many rows/cols are on the board
+  int patternNum;                 // How many patterns are on the board
+  int index;                      // Index of the puzzle within its set
+  unsigned int seed;              // Seed the puzzle was made from
+  std::vector<std::vector<PuzzlePiece>> pieces;  // Corner, edge, inner
+
+}; // GeneratedPuzzle
+
+
+class PuzzleGenerator
+{
+
+private:
+  // Returns a random number from 0 up to but not including the range given.
+  // Uses the raw output of the generator so a seed makes the same puzzle on
+  // every compiler, unlike the standard distributions
+  inline int getRandom(std::mt19937* generator,      // *In-Out*
+                       int range)                    // *In*
+  {
+    return (int)((*generator)() % (unsigned int)range);
+  } // getRandom()
+
+  // Fills the colours of the joins given with the colours from low to high.
+  // Official style spreads the colours evenly then shuffles them, otherwise
+  // each is drawn at random
+  void fillJoins(std::vector<int*>* joins,           // *In-Out*
+                 int low,                            // *In*
+                 int high,                           // *In*
+                 bool isOfficialStyle,               // *In*
+                 std::mt19937* generator);           // *In-Out*
+
+  // Generates the pieces of one puzzle from its size, pattern count and seed.
+  // A colour is drawn for every join between two slots, each piece takes the
+  // colours of the joins around it, border pieces are turned so their edge
+  // is at the bottom, inner pieces are turned at random and the pieces of
+  // each type are shuffled so IDs give nothing away
+  void generate(GeneratedPuzzle* puzzle,             // *In-Out*
+                bool isOfficialStyle);               // *In*
+
+  // Generates the puzzles given from the first index given up to but not
+  // including the last index given
+  void generateRange(std::vector<GeneratedPuzzle>* puzzles,  // *In-Out*
+                     int first,                              // *In*
+                     int last,                               // *In*
+                     bool isOfficialStyle);                  // *In*
+
+public:
+  // Generates count puzzles of the size and pattern count given split across
+  // every hardware thread. Each puzzle is seeded from the corpus seed, size,
+  // pattern count and its index, so the set is the same on any thread count
+  void generateSet(int size,                                 // *In*
+                   int patternNum,                           // *In*
+                   int count,                                // *In*
+                   int seed,                                 // *In*
+                   bool isOfficialStyle,                     // *In*
+                   std::vector<GeneratedPuzzle>* puzzles);   // *Out*
+
+}; // PuzzleGenerator
\ No newline at end of file
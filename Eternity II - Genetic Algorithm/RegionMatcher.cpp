@@ -0,0 +1,308 @@
+// Title        : RegionMatcher.cpp
+// Purpose      : Reassigns freed inner slots optimally with bipartite matching
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#include "RegionMatcher.h"      // Class declaration
+#include "GeneticAlgorithm.h"   // Random number generation
+#include <algorithm>            // min()
+#include <climits>              // INT_MAX
+
+
+RegionMatcher::RegionMatcher(BoardManager* manager)         // *In*
+  : theFitness(manager)
+{ // Stores the board manager of the solver for piece lookup and Zobrist keys
+
+  boardMan = manager;               // Board manager of the solver
+
+} // RegionMatcher()
+
+
+int RegionMatcher::improve(Board* theBoard,                 // *In-Out*
+                           RegionShape shape,               // *In*
+                           int* matchDelta)                 // *Out*
+{ // Frees a row, column or square of inner slots and places the freed pieces
+  // back in the best possible arrangement against the fixed pieces. Returns
+  // the change in fitness, the change in matches is returned in matchDelta
+
+  std::vector<int> assignment;      // Index of piece placed in each slot
+  int oldMatches = 0;               // Matches around freed slots before
+  int newMatches = 0;               // Matches around freed slots after
+  int oldScore = 0;                 // Score around freed slots before
+  int newScore = 0;                 // Score around freed slots after
+  int index[1][2] = { { -1, -1 } }; // Slot to rescore
+
+  *matchDelta = 0;
+
+  chooseSlots(theBoard, shape);
+
+  if (slots.size() < 2)
+  { // If fewer than two slots could be freed there is nothing to reassign
+    return 0;
+  }
+
+  for (int i = 0; i < (int)slots.size(); i++)
+  { // Score the freed slots before they are reassigned. The slots are never
+    // next to each other so every edge is only counted once
+    index[0][0] = slots[i][0];
+    index[0][1] = slots[i][1];
+    oldScore += theFitness.checkLocal(theBoard, index, 1, &oldMatches);
+    *matchDelta -= oldMatches;
+  }
+
+  scoreAssignments(theBoard);       // Score each piece in each slot
+  solveAssignment(&assignment);     // Find the best arrangement
+
+  for (int i = 0; i < (int)slots.size(); i++)
+  { // Place the assigned piece in each slot with its best rotation, swapping
+    // the Zobrist key of the old piece for the new one in the board hash
+    PackedPiece* slot = &theBoard->boardVecs[slots[i][0]][slots[i][1]];
+
+    theBoard->hash ^= boardMan->getZobrist(slots[i][0], slots[i][1],
+                                           pieces[i].pieceID,
+                                           pieces[i].orientation);
+
+    *slot = pieces[assignment[i]];
+    slot->orientation = orients[assignment[i]][i];
+
+    theBoard->hash ^= boardMan->getZobrist(slots[i][0], slots[i][1],
+                                           slot->pieceID, slot->orientation);
+
+    index[0][0] = slots[i][0];
+    index[0][1] = slots[i][1];
+    newScore += theFitness.checkLocal(theBoard, index, 1, &newMatches);
+    *matchDelta += newMatches;
+  }
+
+  return newScore - oldScore;       // Return the change in fitness
+
+} // improve()
+
+
+void RegionMatcher::chooseSlots(Board* theBoard,            // *In*
+                                RegionShape shape)          // *In*
+{ // Frees every other inner slot of a random row, column or square so that
+  // no two freed slots are next to each other, skipping locked slots
+
+  int size = boardMan->getSize();                      // Last index of board
+  int minIndex[2] = { 1, 1 };                          // Top left of region
+  int maxIndex[2] = { size - 1, size - 1 };            // Bottom right of region
+  int parity = -1;                                     // Which slots are freed
+  int line = -1;                                       // Row or column freed
+
+  slots.clear();
+  pieces.clear();
+
+  if (size < 2)
+  { // Board has no inner slots
+    return;
+  }
+
+  if (shape == MATCHROW)
+  { // Free every other slot of a random inner row
+    GeneticAlgorithm::genRandomNum(1, size - 1, &line);
+    minIndex[1] = line;
+    maxIndex[1] = line;
+  }
+  else if (shape == MATCHCOL)
+  { // Free every other slot of a random inner column
+    GeneticAlgorithm::genRandomNum(1, size - 1, &line);
+    minIndex[0] = line;
+    maxIndex[0] = line;
+  }
+  else
+  { // Free every other slot of a random square, clipped to the inner slots
+    GeneticAlgorithm::genRandomNum(1, std::max(1, size - MATCHSQUARE),
+                                   &minIndex[0]);
+    GeneticAlgorithm::genRandomNum(1, std::max(1, size - MATCHSQUARE),
+                                   &minIndex[1]);
+    maxIndex[0] = std::min(size - 1, minIndex[0] + MATCHSQUARE - 1);
+    maxIndex[1] = std::min(size - 1, minIndex[1] + MATCHSQUARE - 1);
+  }
+
+  // Choose whether the odd or even slots of the checkerboard are freed
+  GeneticAlgorithm::genRandomNum(0, 1, &parity);
+
+  for (int i = minIndex[0]; i <= maxIndex[0]; i++)
+  { // X index of slots in region
+    for (int j = minIndex[1]; j <= maxIndex[1]; j++)
+    { // Y index of slots in region
+
+      if ((i + j) % 2 == parity && !boardMan->isLocked(i, j))
+      { // If slot is on the chosen checkerboard colour and is not locked,
+        // free the slot
+        std::vector<int> index = { i, j };
+        slots.push_back(index);
+        pieces.push_back(theBoard->boardVecs[i][j]);
+      }
+    }
+  }
+
+} // chooseSlots()
+
+
+void RegionMatcher::scoreAssignments(Board* theBoard)       // *In*
+{ // Works out the score each freed piece would get in each freed slot against
+  // the fixed pieces around it, storing the best rotation for each pair
+
+  int count = (int)slots.size();                        // Number of slots
+  int xIndex = -1;                                      // Neighbour X index
+  int yIndex = -1;                                      // Neighbour Y index
+  int score = 0;                                        // Score of rotation
+
+  // Neighbour colours of each freed slot, on the top, right, bottom and left
+  std::vector<std::vector<int>> colours(count, std::vector<int>(4, 0));
+
+  // Points each neighbour edge of each freed slot is worth
+  std::vector<std::vector<int>> weights(count, std::vector<int>(4, 0));
+
+  // Offsets to the slots above, to the right, below and to the left
+  const int offsets[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+
+  gains.assign(count, std::vector<int>(count, 0));
+  orients.assign(count, std::vector<int>(count, 0));
+
+  for (int i = 0; i < count; i++)
+  { // Work out the colour and weight of each edge around each freed slot.
+    // Freed slots are all inner so every neighbour is on the board
+    for (int side = TOP; side <= LEFT; side++)
+    {
+      xIndex = slots[i][0] + offsets[side][0];
+      yIndex = slots[i][1] + offsets[side][1];
+
+      colours[i][side] = boardMan->getPattern(theBoard, xIndex, yIndex,
+                                              (segLocation)((side + 2) % 4));
+      weights[i][side] = theFitness.getEdgeWeight(slots[i][0], slots[i][1],
+                                                  xIndex, yIndex);
+    }
+  }
+
+  for (int p = 0; p < count; p++)
+  { // Loop through each freed piece
+    for (int s = 0; s < count; s++)
+    { // Loop through each freed slot
+
+      gains[p][s] = -1;
+
+      for (int orien = 0; orien < 4; orien++)
+      { // Score each rotation of the piece against the fixed neighbours
+
+        score = 0;
+
+        for (int side = TOP; side <= LEFT; side++)
+        {
+          if (boardMan->getSegment(pieces[p].pieceID, orien, side) ==
+              colours[s][side])
+          {
+            score += weights[s][side];
+          }
+        }
+
+        if (score > gains[p][s])
+        { // If best rotation so far, store score and rotation
+          gains[p][s] = score;
+          orients[p][s] = orien;
+        }
+      }
+    }
+  }
+
+} // scoreAssignments()
+
+
+void RegionMatcher::solveAssignment(std::vector<int>* assignment)  // *Out*
+{ // Solves the assignment of pieces to slots with the Hungarian method,
+  // storing the index of the piece for each slot in the assignment vector
+
+  int count = (int)slots.size();          // Number of pieces and slots
+  int maxGain = 0;                        // Highest gain, to turn in to cost
+
+  // Potentials for pieces (u) and slots (v), the piece matched to each slot
+  // (match) and the previous slot on the augmenting path (way). Index 0 is
+  // a dummy slot used to start each path
+  std::vector<int> u(count + 1, 0);
+  std::vector<int> v(count + 1, 0);
+  std::vector<int> match(count + 1, 0);
+  std::vector<int> way(count + 1, 0);
+  std::vector<int> minCost(count + 1, 0);
+  std::vector<bool> isUsed(count + 1, false);
+
+  for (int p = 0; p < count; p++)
+  { // Find the highest gain
+    for (int s = 0; s < count; s++)
+    {
+      maxGain = std::max(maxGain, gains[p][s]);
+    }
+  }
+
+  for (int p = 1; p <= count; p++)
+  { // Add each piece in turn, finding the cheapest augmenting path
+
+    int slot = 0;                         // Current slot on the path
+    match[0] = p;
+    minCost.assign(count + 1, INT_MAX);
+    isUsed.assign(count + 1, false);
+
+    do
+    { // Grow the path until a free slot is reached
+
+      int piece = match[slot];            // Piece matched to current slot
+      int delta = INT_MAX;                // Smallest reduced cost found
+      int nextSlot = 0;                   // Slot with smallest reduced cost
+
+      isUsed[slot] = true;
+
+      for (int s = 1; s <= count; s++)
+      { // Update reduced costs through the current piece
+        if (!isUsed[s])
+        {
+          int cost = (maxGain - gains[piece - 1][s - 1]) - u[piece] - v[s];
+
+          if (cost < minCost[s])
+          {
+            minCost[s] = cost;
+            way[s] = slot;
+          }
+
+          if (minCost[s] < delta)
+          {
+            delta = minCost[s];
+            nextSlot = s;
+          }
+        }
+      }
+
+      for (int s = 0; s <= count; s++)
+      { // Update potentials so the reduced costs stay non negative
+        if (isUsed[s])
+        {
+          u[match[s]] += delta;
+          v[s] -= delta;
+        }
+        else
+        {
+          minCost[s] -= delta;
+        }
+      }
+
+      slot = nextSlot;
+    } while (match[slot] != 0);
+
+    do
+    { // Flip the matches along the augmenting path
+      int prevSlot = way[slot];
+      match[slot] = match[prevSlot];
+      slot = prevSlot;
+    } while (slot != 0);
+
+  } // for p <= count
+
+  assignment->assign(count, 0);
+
+  for (int s = 1; s <= count; s++)
+  { // Store the piece for each slot, 0 based
+    (*assignment)[s - 1] = match[s] - 1;
+  }
+
+} // solveAssignment()
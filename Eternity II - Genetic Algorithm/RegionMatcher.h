@@ -0,0 +1,56 @@
+// Title        : RegionMatcher.h
+// Purpose      : Reassigns freed inner slots optimally with bipartite matching
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#define MATCHSQUARE 6           // Width of the square region that is freed
+
+
+#include "FitnessFunction.h"    // Edge weights, local rescoring
+#include <vector>               // Gain and assignment tables
+
+
+// Readability for the shape of the region that is freed
+enum RegionShape { MATCHROW, MATCHCOL, MATCHREGION, SHAPEDEFAULT };
+
+
+class RegionMatcher
+{
+
+private:
+  FitnessFunction theFitness;                 // Edge weights and rescoring
+  BoardManager* boardMan;                     // Board manager of the solver
+  std::vector<std::vector<int>> slots;        // Indexes of the freed slots
+  std::vector<PackedPiece> pieces;            // Pieces taken from the slots
+  std::vector<std::vector<int>> gains;        // Best score of piece in slot
+  std::vector<std::vector<int>> orients;      // Rotation giving best score
+
+  // Frees every other inner slot of a random row, column or square so that
+  // no two freed slots are next to each other, skipping locked slots
+  void chooseSlots(Board* theBoard,                       // *In*
+                   RegionShape shape);                    // *In*
+
+  // Works out the score each freed piece would get in each freed slot against
+  // the fixed pieces around it, storing the best rotation for each pair
+  void scoreAssignments(Board* theBoard);                 // *In*
+
+  // Solves the assignment of pieces to slots with the Hungarian method,
+  // storing the index of the piece for each slot in the assignment vector
+  void solveAssignment(std::vector<int>* assignment);     // *Out*
+
+public:
+  // Stores the board manager of the solver for piece lookup and Zobrist keys
+  RegionMatcher(BoardManager* manager);                   // *In*
+
+  // Frees a row, column or square of inner slots and places the freed pieces
+  // back in the best possible arrangement against the fixed pieces. Returns
+  // the change in fitness, the change in matches is returned in matchDelta
+  int improve(Board* theBoard,                            // *In-Out*
+              RegionShape shape,                          // *In*
+              int* matchDelta);                           // *Out*
+
+}; // RegionMatcher
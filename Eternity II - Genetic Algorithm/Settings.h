@@ -0,0 +1,54 @@
+// Title        : Settings.h
+// Purpose      : Holds the settings of one solve attempt
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#define TOURNAMENTDEFAULT 10    // Boards per tournament when not set
+
+
+#include "Crossover.h"          // Selection and crossover methods
+#include "Mutation.h"           // Mutation methods
+
+
+// Readability for how the population is restarted when it stops improving
+enum RestartPolicy { FULLRESTART, KEEPELITE, MUTATEBEST, RESTARTDEFAULT };
+
+// Readability for whether generations are replaced whole or one child at a time
+enum GAType { GENERATIONAL, STEADYWORST, STEADYTOURNAMENT, FUSED, GADEFAULT };
+
+// Readability for which solver pipeline is run
+enum SolverMode { GASOLVER, BORDERFIRST, EDASOLVER, ACOSOLVER, EXHAUSTIVE,
+                  SOLVERDEFAULT };
+
+
+struct Settings
+{ // Holds every setting read from the settings file for one solve attempt, so
+  // solvers with different settings can run side by side in one process
+
+  int boardSize;                  // How many rows/cols are on the board
+  int patternNum;                 // How many patterns are on the board
+  int popSize;                    // How many candidates per generation
+  SelectionType selectMethod;     // Which selection method to use
+  CrossoverType crossMethod;      // Which crossover method to use
+  MutateType mutMethod;           // Which mutation method to use
+  double mutRate;                 // What mutation rate should be applied
+  int eliteRate;                  // How many candidates to save per generation
+  bool isStartPiece;              // Whether the start constraint is active
+  RestartPolicy restartMethod;    // How to restart a stuck population
+  GAType gaMode;                  // Generational or steady state
+  int tournamentSize;             // Boards in each selection tournament
+  SolverMode solverMode;          // Which solver pipeline to run
+  bool isBatchFitness;            // Whether boards are checked in batches
+  bool isMismatchBias;            // Whether mutation favours mismatched slots
+  int solutionCount;              // Distinct solutions to find before stopping
+  bool isGenerator;               // Whether to write a corpus instead
+  int timeLimit;                  // Seconds to run before stopping, 0 = none
+  int generationLimit;            // Generations before stopping, 0 = none
+  int evaluationLimit;            // Fitness checks before stopping, 0 = none
+  int targetMatch;                // Match percentage to stop at
+
+}; // Settings
\ No newline at end of file
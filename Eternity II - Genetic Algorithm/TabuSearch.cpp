@@ -0,0 +1,345 @@
+// Title        : TabuSearch.cpp
+// Purpose      : Improves a single board with tabu search using local rescoring
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#include "TabuSearch.h"         // Class declaration
+#include "GeneticAlgorithm.h"   // Random number generation
+
+
+TabuSearch::TabuSearch(BoardManager* manager)             // *In*
+  : theFitness(manager), theMatcher(manager)
+{ // Initialises the tabu list and stores the board manager of the solver
+
+  tabuList.assign(TABUSIZE, 0);   // No move is tabu to begin with
+  iteration = 0;                  // Initialise iteration count
+  boardMan = manager;             // Board manager of the solver
+
+} // TabuSearch()
+
+
+void TabuSearch::search(Board* theBoard,                  // *In-Out*
+                        int iterations)                   // *In*
+{ // Runs tabu search on the board for the given number of iterations, leaving
+  // the best board found within the board given
+
+  Board bestBoard;                  // Best board found during the search
+  TabuMove move;                    // Candidate move being scored
+  TabuMove bestMove;                // Best candidate found this iteration
+  PackedPiece oldPieces[2];         // Pieces removed by the chosen move
+  bool isFound = false;             // Whether an allowed move was found
+  int sinceBest = 0;                // Iterations since best board improved
+  int shape = -1;                   // Shape of region to reassign
+  int matchDelta = 0;               // Change in matches from reassignment
+
+  tabuList.assign(TABUSIZE, 0);     // Clear the tabu list from previous search
+  iteration = 0;                    // Reset the iteration count
+
+  theFitness.checkFitness(theBoard);  // Full score once to start the deltas
+  bestBoard = *theBoard;              // Board given is the best so far
+
+  for (iteration = 1; iteration <= iterations; iteration++)
+  { // Loop for each iteration, picking the best sampled move each time
+
+    isFound = false;
+
+    for (int i = 0; i < TABUCANDIDATES; i++)
+    { // Sample candidate moves rather than scoring every possible swap
+
+      sampleMove(theBoard, &move);
+      scoreMove(theBoard, &move);
+
+      if (isMoveTabu(theBoard, &move) &&
+          theBoard->fitScore + move.delta <= bestBoard.fitScore)
+      { // If the move is tabu and does not meet the aspiration criterion of
+        // beating the best board found, do not consider it
+        continue;
+      }
+
+      if (!isFound || move.delta > bestMove.delta)
+      { // If first allowed move or better than the best so far, store it
+        bestMove = move;
+        isFound = true;
+      }
+    } // for i < TABUCANDIDATES
+
+    if (isFound)
+    { // Make the best move, marking the placements it removed as tabu
+
+      applyMove(theBoard, &bestMove, oldPieces);
+
+      makeTabu(bestMove.index1[0], bestMove.index1[1], oldPieces[0].pieceID,
+               oldPieces[0].orientation);
+      makeTabu(bestMove.index2[0], bestMove.index2[1], oldPieces[1].pieceID,
+               oldPieces[1].orientation);
+
+      theBoard->fitScore += bestMove.delta;         // Update the fitness
+      theBoard->matchCount += bestMove.matchDelta;  // Update the match count
+    }
+
+    if (sinceBest >= TABUSTALL)
+    { // If the search has stalled, make a large move by optimally reassigning
+      // a random row, column or square of inner pieces
+      GeneticAlgorithm::genRandomNum(MATCHROW, MATCHREGION, &shape);
+
+      theBoard->fitScore += theMatcher.improve(theBoard, (RegionShape)shape,
+                                               &matchDelta);
+      theBoard->matchCount += matchDelta;
+      sinceBest = 0;
+    }
+
+    if (theBoard->fitScore > bestBoard.fitScore)
+    { // If new best board has been found, store it
+      bestBoard = *theBoard;
+      sinceBest = 0;
+    }
+    else
+    { // Otherwise count iteration towards a stall
+      sinceBest++;
+    }
+  } // for iteration <= iterations
+
+  *theBoard = bestBoard;            // Leave the best board found in the board
+
+} // search()
+
+
+int TabuSearch::hashMove(int xIndex,                      // *In*
+                         int yIndex,                      // *In*
+                         int pieceID,                     // *In*
+                         int orientation)                 // *In*
+{ // Hashes a (slot, piece, orientation) placement in to an index of the tabu
+  // list
+
+  unsigned int hash = 2166136261u;  // FNV offset basis
+
+  // Mix each part of the placement in to the hash
+  hash = (hash ^ (unsigned int)xIndex) * 16777619u;
+  hash = (hash ^ (unsigned int)yIndex) * 16777619u;
+  hash = (hash ^ (unsigned int)pieceID) * 16777619u;
+  hash = (hash ^ (unsigned int)orientation) * 16777619u;
+
+  return (int)(hash & (TABUSIZE - 1));  // Keep within the tabu list
+
+} // hashMove()
+
+
+bool TabuSearch::isTabu(int xIndex,                       // *In*
+                        int yIndex,                       // *In*
+                        int pieceID,                      // *In*
+                        int orientation)                  // *In*
+{ // Returns whether placing the piece in the slot with the orientation given
+  // is currently tabu
+
+  return tabuList[hashMove(xIndex, yIndex, pieceID, orientation)] > iteration;
+
+} // isTabu()
+
+
+void TabuSearch::makeTabu(int xIndex,                     // *In*
+                          int yIndex,                     // *In*
+                          int pieceID,                    // *In*
+                          int orientation)                // *In*
+{ // Marks the placement of the piece in the slot as tabu for TABUTENURE
+  // iterations so the search does not move it straight back
+
+  tabuList[hashMove(xIndex, yIndex, pieceID, orientation)] =
+    iteration + TABUTENURE;
+
+} // makeTabu()
+
+
+int TabuSearch::getRandSlot(int index[2],                 // *Out*
+                            int type,                     // *In*
+                            int skip)                     // *In*
+{ // Sets the 2 dimensional index for a random free slot of the type given,
+  // never the free slot numbered skip (-1 for any). Locked slots are not in
+  // the free slots so are never chosen. Returns the number of the free slot
+
+  std::vector<int>* slots = boardMan->getFreeSlots(type);  // Free slots
+  int choice = -1;                                     // Free slot chosen
+
+  if (skip < 0)
+  { // Any free slot can be chosen
+    GeneticAlgorithm::genRandomNum(0, (int)slots->size() - 1, &choice);
+  }
+  else
+  { // Choose from one fewer slots, stepping over the slot to skip
+    GeneticAlgorithm::genRandomNum(0, (int)slots->size() - 2, &choice);
+
+    if (choice >= skip)
+    {
+      choice++;
+    }
+  }
+
+  boardMan->getSlotIndex((*slots)[choice], index);
+
+  return choice;     // Return the number of the free slot chosen
+
+} // getRandSlot()
+
+
+void TabuSearch::sampleMove(Board* theBoard,              // *In*
+                            TabuMove* move)               // *Out*
+{ // Generates a random swap or rotate move, making sure both slots hold the
+  // same type of piece
+
+  int type = -1;          // Type of piece to move
+  int isRotate = -1;      // Whether an inner move should only rotate
+  int first = -1;         // Number of the first free slot chosen
+
+  // Get random piece type for the move
+  GeneticAlgorithm::genRandomNum(0, 2, &type);
+
+  if (type != INNER && boardMan->getFreeSlots(type)->size() < 2)
+  { // Border pieces can only be swapped, so move inner pieces if fewer than
+    // two border slots of the type are free
+    type = INNER;
+  }
+
+  // Boards with a single free inner slot can only rotate inner pieces
+  int innerCount = (int)boardMan->getFreeSlots(INNER)->size();
+
+  GeneticAlgorithm::genRandomNum(0, 3, &isRotate);
+
+  first = getRandSlot(move->index1, type, -1);
+
+  if (type == INNER && (isRotate == 0 || innerCount < 2))
+  { // One in four inner moves rotates a single piece in place
+    move->index2[0] = move->index1[0];
+    move->index2[1] = move->index1[1];
+  }
+  else
+  { // Otherwise swap with a different free slot of the same type
+    getRandSlot(move->index2, type, first);
+  }
+
+  if (type == INNER)
+  { // Inner pieces are given random orientations in their new slots
+    GeneticAlgorithm::genRandomNum(0, 3, &move->orien1);
+    GeneticAlgorithm::genRandomNum(0, 3, &move->orien2);
+  }
+  else
+  { // Border orientations are fixed by the slot when the move is applied
+    move->orien1 = -1;
+    move->orien2 = -1;
+  }
+
+  if (move->index1[0] == move->index2[0] && move->index1[1] == move->index2[1])
+  { // Make sure a rotate move actually changes the orientation, both
+    // orientations are the same as only one piece is placed
+    if (move->orien1 ==
+        theBoard->boardVecs[move->index1[0]][move->index1[1]].orientation)
+    {
+      move->orien1 = (move->orien1 + 1) % 4;
+    }
+
+    move->orien2 = move->orien1;
+  }
+
+} // sampleMove()
+
+
+void TabuSearch::applyMove(Board* theBoard,               // *In-Out*
+                           TabuMove* move,                // *In*
+                           PackedPiece oldPieces[2])      // *Out*
+{ // Places the pieces of the move in the board, returns the pieces that were
+  // in the slots in the old pieces array so the move can be reverted
+
+  PackedPiece* slot1 = &theBoard->boardVecs[move->index1[0]][move->index1[1]];
+  PackedPiece* slot2 = &theBoard->boardVecs[move->index2[0]][move->index2[1]];
+
+  oldPieces[0] = *slot1;          // Store the piece in the first slot
+  oldPieces[1] = *slot2;          // Store the piece in the second slot
+
+  *slot1 = oldPieces[1];          // Move second piece in to first slot
+  *slot2 = oldPieces[0];          // Move first piece in to second slot
+
+  if (slot1 == slot2)
+  { // If the move is a rotation, only set the new orientation
+    slot1->orientation = move->orien1;
+  }
+  else if (boardMan->getPiece(slot1->pieceID)->type == INNER)
+  { // If inner pieces were swapped, set their new orientations
+    slot1->orientation = move->orien1;
+    slot2->orientation = move->orien2;
+  }
+  else
+  { // Border pieces are rotated to face the edge of their new slots
+    boardMan->fixOrien(slot1, move->index1[0], move->index1[1]);
+    boardMan->fixOrien(slot2, move->index2[0], move->index2[1]);
+  }
+
+} // applyMove()
+
+
+void TabuSearch::revertMove(Board* theBoard,              // *In-Out*
+                            TabuMove* move,               // *In*
+                            PackedPiece oldPieces[2])     // *In*
+{ // Puts the pieces stored by applyMove back in to the slots of the move
+
+  // Put second piece back first so a rotation restores the original piece
+  theBoard->boardVecs[move->index2[0]][move->index2[1]] = oldPieces[1];
+  theBoard->boardVecs[move->index1[0]][move->index1[1]] = oldPieces[0];
+
+} // revertMove()
+
+
+void TabuSearch::scoreMove(Board* theBoard,               // *In-Out*
+                           TabuMove* move)                // *In-Out*
+{ // Scores the move by rescoring only the edges around the slots it touches
+
+  PackedPiece oldPieces[2];               // Pieces to restore after scoring
+  int slots[2][2] = { { move->index1[0], move->index1[1] },
+                      { move->index2[0], move->index2[1] } };
+  int slotCount = (move->index1[0] == move->index2[0] &&
+                   move->index1[1] == move->index2[1]) ? 1 : 2;
+  int oldMatches = 0;                     // Matches around slots before move
+  int newMatches = 0;                     // Matches around slots after move
+
+  // Score the edges before the move
+  int oldScore = theFitness.checkLocal(theBoard, slots, slotCount, &oldMatches);
+
+  applyMove(theBoard, move, oldPieces);   // Make the move to score it
+
+  // Score the edges after the move
+  int newScore = theFitness.checkLocal(theBoard, slots, slotCount, &newMatches);
+
+  revertMove(theBoard, move, oldPieces);  // Undo the move
+
+  move->delta = newScore - oldScore;          // Store change in fitness
+  move->matchDelta = newMatches - oldMatches; // Store change in matches
+
+} // scoreMove()
+
+
+bool TabuSearch::isMoveTabu(Board* theBoard,              // *In*
+                            TabuMove* move)               // *In*
+{ // Returns whether the move places a piece that is currently tabu
+
+  PackedPiece* piece1 = &theBoard->boardVecs[move->index1[0]][move->index1[1]];
+  PackedPiece* piece2 = &theBoard->boardVecs[move->index2[0]][move->index2[1]];
+
+  // Border pieces are keyed with the orientation their new slot would force
+  PackedPiece moved1 = *piece2;
+  PackedPiece moved2 = *piece1;
+
+  if (boardMan->getPiece(moved1.pieceID)->type == INNER)
+  { // Inner pieces use the orientation chosen by the move
+    moved1.orientation = move->orien1;
+    moved2.orientation = move->orien2;
+  }
+  else
+  { // Border pieces are rotated to face the edge of their new slots
+    boardMan->fixOrien(&moved1, move->index1[0], move->index1[1]);
+    boardMan->fixOrien(&moved2, move->index2[0], move->index2[1]);
+  }
+
+  return isTabu(move->index1[0], move->index1[1], moved1.pieceID,
+                moved1.orientation) ||
+         isTabu(move->index2[0], move->index2[1], moved2.pieceID,
+                moved2.orientation);
+
+} // isMoveTabu()
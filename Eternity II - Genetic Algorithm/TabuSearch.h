@@ -0,0 +1,108 @@
+// Title        : TabuSearch.h
+// Purpose      : Improves a single board with tabu search using local rescoring
+// Author       : Matthew Jacques
+// Date         : 18/10/2026
+
+
+#pragma once                    // Only include once
+
+
+#define TABUSIZE       4096     // Slots in hashed tabu list (power of two)
+#define TABUTENURE     25       // How many iterations a move stays tabu
+#define TABUCANDIDATES 40       // How many moves are sampled per iteration
+#define TABUITERATIONS 3000     // Iterations used when escaping a plateau
+#define TABUSTALL      300      // Iterations without a new best before a
+                                // region is reassigned by matching
+
+
+#include "FitnessFunction.h"    // Local edge rescoring, board definition
+#include "RegionMatcher.h"      // Large moves when the search stalls
+#include <vector>               // Hashed tabu list
+
+
+struct TabuMove
+{ // Holds a candidate move, two slots with the orientation each piece will
+  // have after the move. If both indexes are equal the move is a rotation
+
+  int index1[2];      // Index of the first slot of the move
+  int index2[2];      // Index of the second slot of the move
+  int orien1;         // Orientation of piece placed in first slot
+  int orien2;         // Orientation of piece placed in second slot
+  int delta;          // Change in fitness if the move is made
+  int matchDelta;     // Change in pattern matches if the move is made
+
+}; // TabuMove
+
+
+class TabuSearch
+{
+
+private:
+  FitnessFunction theFitness;           // Local rescoring of edges
+  RegionMatcher theMatcher;             // Reassigns regions when stalled
+  std::vector<int> tabuList;            // Iteration each hashed move expires
+  int iteration;                        // Current iteration of the search
+  BoardManager* boardMan;               // Board manager of the solver
+
+  // Hashes a (slot, piece, orientation) placement in to an index of the tabu
+  // list
+  int hashMove(int xIndex,                              // *In*
+               int yIndex,                              // *In*
+               int pieceID,                             // *In*
+               int orientation);                        // *In*
+
+  // Returns whether placing the piece in the slot with the orientation given
+  // is currently tabu
+  bool isTabu(int xIndex,                               // *In*
+              int yIndex,                               // *In*
+              int pieceID,                              // *In*
+              int orientation);                         // *In*
+
+  // Marks the placement of the piece in the slot as tabu for TABUTENURE
+  // iterations so the search does not move it straight back
+  void makeTabu(int xIndex,                             // *In*
+                int yIndex,                             // *In*
+                int pieceID,                            // *In*
+                int orientation);                       // *In*
+
+  // Sets the 2 dimensional index for a random free slot of the type given,
+  // never the free slot numbered skip (-1 for any). Locked slots are not in
+  // the free slots so are never chosen. Returns the number of the free slot
+  int getRandSlot(int index[2],                         // *Out*
+                  int type,                             // *In*
+                  int skip);                            // *In*
+
+  // Generates a random swap or rotate move, making sure both slots hold the
+  // same type of piece
+  void sampleMove(Board* theBoard,                      // *In*
+                  TabuMove* move);                      // *Out*
+
+  // Places the pieces of the move in the board, returns the pieces that were
+  // in the slots in the old pieces array so the move can be reverted
+  void applyMove(Board* theBoard,                       // *In-Out*
+                 TabuMove* move,                        // *In*
+                 PackedPiece oldPieces[2]);             // *Out*
+
+  // Puts the pieces stored by applyMove back in to the slots of the move
+  void revertMove(Board* theBoard,                      // *In-Out*
+                  TabuMove* move,                       // *In*
+                  PackedPiece oldPieces[2]);            // *In*
+
+  // Scores the move by rescoring only the edges around the slots it touches
+  void scoreMove(Board* theBoard,                       // *In-Out*
+                 TabuMove* move);                       // *In-Out*
+
+  // Returns whether the move places a piece that is currently tabu
+  bool isMoveTabu(Board* theBoard,                      // *In*
+                  TabuMove* move);                      // *In*
+
+public:
+  // Initialises the tabu list and stores the board manager of the solver
+  TabuSearch(BoardManager* manager);                    // *In*
+
+  // Runs tabu search on the board for the given number of iterations, leaving
+  // the best board found within the board given
+  void search(Board* theBoard,                          // *In-Out*
+              int iterations);                          // *In*
+
+}; // TabuSearch